@@ -0,0 +1,87 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "bench_util.h"
+#include "grafo.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+// mede o tempo do cálculo de vértices e arestas de corte em grafos muito
+// profundos, onde uma busca em profundidade recursiva estouraria a pilha, e o
+// da montagem das strings de vertices_corte() e arestas_corte()
+//
+// uso: bench_cortes [vertices_caminho] [lado_grade]
+//
+// são gerados um caminho com 'vertices_caminho' vértices (10 milhões por padrão)
+// e uma grade de 'lado_grade' x 'lado_grade' vértices (2000 por padrão); no
+// caminho todo vértice interno é de corte e toda aresta é de corte, na grade
+// não há cortes
+
+long peak_kb(void);
+int time_cuts(const char* graph, int (*write)(FILE*, unsigned long), unsigned long n);
+
+//------------------------------------------------------------------------------
+// devolve o pico de memória residente do processo em KB
+long peak_kb(void)
+{
+    struct rusage ru;
+
+    getrusage(RUSAGE_SELF, &ru);
+
+    return ru.ru_maxrss;
+}
+
+//------------------------------------------------------------------------------
+// gera o grafo 'graph' com 'write', lê e calcula seus cortes, imprimindo uma linha
+// do CSV com os tempos em segundos; devolve 0 se algo falhou
+int time_cuts(const char* graph, int (*write)(FILE*, unsigned long), unsigned long n)
+{
+    char path[] = "/tmp/bench_cortesXXXXXX";
+    double t_read, t_cut, t_str;
+    grafo* g;
+
+    if (!write_temp(path, write, n))
+        return 0;
+
+    t_read = now();
+    g = le_grafo_arquivo(path);
+    unlink(path);
+    if (!g) {
+        fprintf(stderr, "nao foi possivel ler o grafo %s\n", graph);
+        return 0;
+    }
+    t_read = now() - t_read;
+
+    t_cut = now();
+    pre_calcula(g, CALCULA_CORTES);
+    t_cut = now() - t_cut;
+
+    t_str = now();
+    free(vertices_corte(g));
+    free(arestas_corte(g));
+    t_str = now() - t_str;
+
+    printf("%s,%u,%u,%.3f,%.3f,%.3f,%ld\n", graph, n_vertices(g), n_arestas(g), t_read, t_cut,
+        t_str, peak_kb());
+
+    destroi_grafo(g);
+
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    unsigned long path_n = (argc > 1) ? strtoul(argv[1], NULL, 10) : 10000000;
+    unsigned long side = (argc > 2) ? strtoul(argv[2], NULL, 10) : 2000;
+
+    printf("grafo,vertices,arestas,leitura,cortes,strings,pico_kb\n");
+
+    if ((path_n > 0) && !time_cuts("caminho", write_path, path_n - 1))
+        return 1;
+    if ((side > 0) && !time_cuts("grade", write_square_grid, side))
+        return 1;
+
+    return 0;
+}
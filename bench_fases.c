@@ -0,0 +1,349 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "bench_util.h"
+#include "grafo.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// mede o tempo de cada fase da análise de grafos sintéticos de vários tamanhos:
+// leitura, componentes, bipartição, cortes e diâmetros
+//
+// uso: bench_fases [max_arestas] [formato] [max_diametro] [max_todas_origens]
+//
+// para cada gerador são gerados grafos com cerca de 1000, 10000, ... arestas até
+// 'max_arestas' (10 milhões por padrão); cada grafo é lido e analisado uma vez por
+// modo de cálculo dos diâmetros: "limites" (o padrão da biblioteca), "heap" (limites
+// com Dijkstra numa heap binária) e, até 'max_todas_origens' arestas (10000 por
+// padrão), "todas_origens". Os diâmetros só são medidos até 'max_diametro' arestas
+// (100000 por padrão), e só os modos "limites" e os de reordenação são medidos nos
+// grafos maiores
+//
+// os modos "rcm", "bfs" e "grau" calculam os diâmetros como "limites", mas antes
+// renumeram os vértices com reordena_vertices(), cujo tempo fica na coluna
+// 'reordenacao'
+//
+// 'formato' é csv (o padrão) ou json; os tempos são em segundos e as fases não
+// medidas ficam vazias (null em json)
+//
+// uso: bench_fases componentes [arestas] [max_threads]
+//
+// mede só n_componentes() num caminho, numa grade e num grafo aleatório com cerca
+// de 'arestas' arestas (10 milhões por padrão), com uma thread, que rotula os
+// componentes com a busca em largura da bipartição, e com 2, 4, ... até
+// 'max_threads' threads (uma por processador por padrão), que os rotulam com uma
+// union-find compartilhada. O resultado sai em CSV
+
+// gerador de um grafo com cerca de 'm' arestas, escrito em 'out'
+typedef struct generator {
+    const char* name;
+    int (*write)(FILE* out, unsigned long m);
+} generator;
+
+// tempos de uma análise
+typedef struct phases {
+    unsigned int vertices;
+    unsigned int arestas;
+    double leitura;
+    double reordenacao; // negativo se os vértices não foram renumerados
+    double componentes;
+    double bipartido;
+    double cortes;
+    double diametros; // negativo se não foi medido
+    unsigned int dijkstra;
+} phases;
+
+int write_power_law(FILE* out, unsigned long m);
+int write_complete(FILE* out, unsigned long m);
+int write_chain(FILE* out, unsigned long m);
+int time_phases(const char* path, const char* mode, int diameters, phases* t);
+void print_row(const char* format, const char* graph, unsigned long m, const char* mode,
+    const phases* t, int first);
+int time_components(const char* path, unsigned int n_threads, double* t, unsigned int* c);
+int bench_components(int argc, char** argv);
+
+//------------------------------------------------------------------------------
+// escreve em 'out' um grafo com distribuição de graus em lei de potência, pelo
+// modelo de Barabási-Albert: cada vértice novo se liga a 4 vértices escolhidos com
+// probabilidade proporcional ao grau, sorteando pontas das arestas já escritas
+int write_power_law(FILE* out, unsigned long m)
+{
+    unsigned long* end = malloc(sizeof(unsigned long) * 2 * (m + 1));
+    unsigned long n_ends = 0, v = 1;
+
+    if (!end)
+        return 0;
+
+    fprintf(out, "lei_potencia\n");
+    fprintf(out, "l0 -- l1\n");
+    end[n_ends++] = 0;
+    end[n_ends++] = 1;
+    for (unsigned long e = 1; e < m; v++) {
+        unsigned long ends = n_ends;
+
+        for (unsigned int k = 0; (k < 4) && (e < m); k++, e++) {
+            unsigned long w = end[next_random() % ends];
+            fprintf(out, "l%lu -- l%lu\n", v + 1, w);
+            end[n_ends++] = v + 1;
+            end[n_ends++] = w;
+        }
+    }
+    free(end);
+
+    return !ferror(out);
+}
+
+//------------------------------------------------------------------------------
+// escreve em 'out' um grafo completo com cerca de 'm' arestas e pesos de 1 a 5000,
+// como as distâncias de exemplos/cidades.dot
+int write_complete(FILE* out, unsigned long m)
+{
+    unsigned long n = 2;
+
+    while (n * (n - 1) / 2 < m)
+        n++;
+
+    fprintf(out, "completo\n");
+    for (unsigned long i = 0; i < n; i++) {
+        for (unsigned long j = i + 1; j < n; j++)
+            fprintf(out, "c%lu -- c%lu %lu\n", i, j, next_random() % 5000 + 1);
+    }
+
+    return !ferror(out);
+}
+
+//------------------------------------------------------------------------------
+// escreve em 'out' uma corrente de triângulos com 'm' arestas, arredondado para
+// cima a um múltiplo de 3, cada um ligado ao próximo por um vértice de corte: um
+// grafo profundo, com um bloco por triângulo
+int write_chain(FILE* out, unsigned long m)
+{
+    fprintf(out, "corrente\n");
+    for (unsigned long t = 0; t < (m + 2) / 3; t++) {
+        fprintf(out, "t%lu -- t%lu\n", 2 * t, 2 * t + 1);
+        fprintf(out, "t%lu -- t%lu\n", 2 * t + 1, 2 * t + 2);
+        fprintf(out, "t%lu -- t%lu\n", 2 * t + 2, 2 * t);
+    }
+
+    return !ferror(out);
+}
+
+//------------------------------------------------------------------------------
+// lê o grafo em 'path' e mede cada fase da sua análise com os diâmetros calculados
+// no modo 'mode', se 'diameters' não é 0; devolve 0 se o grafo não pôde ser lido
+int time_phases(const char* path, const char* mode, int diameters, phases* t)
+{
+    double start = now();
+    char *s1, *s2;
+    grafo* g;
+
+    if (!(g = le_grafo_arquivo(path)))
+        return 0;
+    t->leitura = now() - start;
+    t->vertices = n_vertices(g);
+    t->arestas = n_arestas(g);
+
+    if (!strcmp(mode, "todas_origens"))
+        define_modo_diametro(g, DIAMETRO_TODAS_ORIGENS);
+    else if (!strcmp(mode, "heap"))
+        define_algoritmo_caminhos(g, CAMINHOS_HEAP);
+
+    t->reordenacao = -1;
+    if (!strcmp(mode, "rcm") || !strcmp(mode, "bfs") || !strcmp(mode, "grau")) {
+        start = now();
+        reordena_vertices(g, !strcmp(mode, "rcm") ? ORDEM_RCM
+                                                  : (!strcmp(mode, "bfs") ? ORDEM_BFS : ORDEM_GRAU),
+            NULL);
+        t->reordenacao = now() - start;
+    }
+
+    start = now();
+    n_componentes(g);
+    t->componentes = now() - start;
+
+    start = now();
+    bipartido(g);
+    t->bipartido = now() - start;
+
+    start = now();
+    s1 = vertices_corte(g);
+    s2 = arestas_corte(g);
+    t->cortes = now() - start;
+    free(s1);
+    free(s2);
+
+    t->diametros = -1;
+    t->dijkstra = 0;
+    if (diameters) {
+        start = now();
+        free(diametros(g));
+        t->diametros = now() - start;
+        t->dijkstra = execucoes_dijkstra(g);
+    }
+
+    destroi_grafo(g);
+
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+// imprime os tempos 't' como uma linha do CSV ou um objeto do vetor JSON
+void print_row(const char* format, const char* graph, unsigned long m, const char* mode,
+    const phases* t, int first)
+{
+    char reorder[32] = "", diam[32] = "", dijkstra[32] = "";
+
+    if (!strcmp(format, "json")) {
+        strcpy(reorder, "null");
+        strcpy(diam, "null");
+        strcpy(dijkstra, "null");
+    }
+    if (t->reordenacao >= 0)
+        snprintf(reorder, sizeof(reorder), "%.4f", t->reordenacao);
+    if (t->diametros >= 0) {
+        snprintf(diam, sizeof(diam), "%.4f", t->diametros);
+        snprintf(dijkstra, sizeof(dijkstra), "%u", t->dijkstra);
+    }
+
+    if (!strcmp(format, "json"))
+        printf("%s  {\"grafo\": \"%s\", \"arestas_alvo\": %lu, \"vertices\": %u, \"arestas\": %u, "
+               "\"modo\": \"%s\", \"leitura\": %.4f, \"reordenacao\": %s, \"componentes\": %.4f, "
+               "\"bipartido\": %.4f, \"cortes\": %.4f, \"diametros\": %s, \"dijkstra\": %s}",
+            first ? "" : ",\n", graph, m, t->vertices, t->arestas, mode, t->leitura, reorder,
+            t->componentes, t->bipartido, t->cortes, diam, dijkstra);
+    else
+        printf("%s,%lu,%u,%u,%s,%.4f,%s,%.4f,%.4f,%.4f,%s,%s\n", graph, m, t->vertices,
+            t->arestas, mode, t->leitura, reorder, t->componentes, t->bipartido, t->cortes, diam,
+            dijkstra);
+    fflush(stdout);
+}
+
+//------------------------------------------------------------------------------
+// lê o grafo em 'path' e mede em 't' o tempo em segundos de n_componentes() com
+// 'n_threads' threads, que fica em 'c'; devolve 0 se o grafo não pôde ser lido
+int time_components(const char* path, unsigned int n_threads, double* t, unsigned int* c)
+{
+    grafo* g;
+    double start;
+
+    if (!(g = le_grafo_arquivo(path)))
+        return 0;
+
+    define_n_threads(g, n_threads);
+    start = now();
+    *c = n_componentes(g);
+    *t = now() - start;
+    destroi_grafo(g);
+
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+// modo componentes: bench_fases componentes [arestas] [max_threads]
+int bench_components(int argc, char** argv)
+{
+    static const generator generators[] = { { "caminho", write_path }, { "grade", write_grid },
+        { "aleatorio", write_gnm } };
+    unsigned long m = (argc > 1) ? strtoul(argv[1], NULL, 10) : 10000000;
+    long n_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    unsigned int max_threads = (argc > 2) ? (unsigned int)atoi(argv[2])
+                                          : (unsigned int)(n_cpus > 0 ? n_cpus : 1);
+    unsigned int c, c1;
+    double t, t1;
+
+    printf("grafo,threads,segundos,aceleracao,componentes\n");
+
+    for (size_t i = 0; i < sizeof(generators) / sizeof(generators[0]); i++) {
+        char path[] = "/tmp/bench_fasesXXXXXX";
+
+        seed_random(0x9e3779b97f4a7c15ull + m);
+        if (!write_temp(path, generators[i].write, m))
+            return 1;
+
+        if (!time_components(path, 1, &t1, &c1)) {
+            fprintf(stderr, "nao foi possivel ler o grafo %s\n", generators[i].name);
+            unlink(path);
+            return 1;
+        }
+        printf("%s,1,%.3f,1.00,%u\n", generators[i].name, t1, c1);
+
+        for (unsigned int n = 2; n <= max_threads; n *= 2) {
+            if (!time_components(path, n, &t, &c)) {
+                fprintf(stderr, "nao foi possivel ler o grafo %s com %u threads\n",
+                    generators[i].name, n);
+                unlink(path);
+                return 1;
+            }
+            printf("%s,%u,%.3f,%.2f,%u\n", generators[i].name, n, t, t1 / t, c);
+            if (c != c1)
+                fprintf(stderr, "resultado diferente com %u threads\n", n);
+        }
+
+        unlink(path);
+    }
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    static const generator generators[] = { { "caminho", write_path }, { "grade", write_grid },
+        { "aleatorio", write_gnm }, { "lei_potencia", write_power_law },
+        { "completo", write_complete }, { "corrente", write_chain } };
+    static const char* modes[] = { "limites", "heap", "todas_origens", "rcm", "bfs", "grau" };
+    unsigned long max_m = (argc > 1) ? strtoul(argv[1], NULL, 10) : 10000000;
+    const char* format = (argc > 2) ? argv[2] : "csv";
+    unsigned long max_diam = (argc > 3) ? strtoul(argv[3], NULL, 10) : 100000;
+    unsigned long max_all = (argc > 4) ? strtoul(argv[4], NULL, 10) : 10000;
+    int first = 1;
+
+    if ((argc > 1) && !strcmp(argv[1], "componentes"))
+        return bench_components(argc - 1, argv + 1);
+
+    if (strcmp(format, "csv") && strcmp(format, "json")) {
+        fprintf(stderr, "formato deve ser csv ou json\n");
+        return 1;
+    }
+
+    if (!strcmp(format, "json"))
+        printf("[\n");
+    else
+        printf("grafo,arestas_alvo,vertices,arestas,modo,leitura,reordenacao,componentes,bipartido,"
+               "cortes,diametros,dijkstra\n");
+
+    for (unsigned int k = 0; k < sizeof(generators) / sizeof(generators[0]); k++) {
+        for (unsigned long m = 1000; m <= max_m; m *= 10) {
+            char path[] = "/tmp/bench_fasesXXXXXX";
+
+            // a sequência é reiniciada para cada grafo, então os grafos gerados são
+            // sempre os mesmos
+            seed_random(0x9e3779b97f4a7c15ull + m);
+            if (!write_temp(path, generators[k].write, m))
+                return 1;
+
+            for (unsigned int i = 0; i < sizeof(modes) / sizeof(modes[0]); i++) {
+                phases t;
+
+                // heap e todas_origens só mudam os diâmetros
+                if (((i == 1) || (i == 2)) && ((m > max_diam) || ((i == 2) && (m > max_all))))
+                    continue;
+                if (!time_phases(path, modes[i], m <= max_diam, &t)) {
+                    fprintf(stderr, "nao foi possivel ler o grafo %s\n", generators[k].name);
+                    unlink(path);
+                    return 1;
+                }
+                print_row(format, generators[k].name, m, modes[i], &t, first);
+                first = 0;
+            }
+
+            unlink(path);
+        }
+    }
+
+    if (!strcmp(format, "json"))
+        printf("\n]\n");
+
+    return 0;
+}
@@ -0,0 +1,135 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "bench_util.h"
+#include "grafo.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// mede o tempo de leitura de um arquivo grande com le_grafo() e com
+// le_grafo_arquivo_paralelo() variando o número de threads
+//
+// uso: bench_leitura [linhas] [max_threads] [arquivo_base]
+//
+// o arquivo lido é gerado replicando as linhas de 'arquivo_base' (por padrão
+// exemplos/cidades.dot) até completar 'linhas' linhas; os nomes dos vértices
+// de cada cópia recebem o número da cópia como sufixo
+
+unsigned long replicate(const char* base, FILE* out, unsigned long n_lines);
+double time_load(const char* path, unsigned int n_threads, unsigned int* v, unsigned int* e);
+
+//------------------------------------------------------------------------------
+// escreve em 'out' cópias das linhas de 'base' até completar 'n_lines' linhas
+// devolve o número de linhas escritas
+unsigned long replicate(const char* base, FILE* out, unsigned long n_lines)
+{
+    char line[2048], x[2048], y[2048];
+    unsigned long written = 0;
+    unsigned long copy = 0;
+    int p, res;
+    FILE* f;
+
+    fprintf(out, "replicado\n");
+
+    while (written < n_lines) {
+        if (!(f = fopen(base, "r")))
+            return 0;
+
+        while ((written < n_lines) && fgets(line, sizeof(line), f)) {
+            if ((line[0] == '/') || (line[0] == '\n'))
+                continue;
+
+            res = sscanf(line, "%2047s -- %2047s %d", x, y, &p);
+            if (res == 3)
+                fprintf(out, "%s_%lu -- %s_%lu %d\n", x, copy, y, copy, p);
+            else if (res == 2)
+                fprintf(out, "%s_%lu -- %s_%lu\n", x, copy, y, copy);
+            else if (res == 1)
+                fprintf(out, "%s_%lu\n", x, copy);
+            else
+                continue;
+            written++;
+        }
+
+        fclose(f);
+        copy++;
+    }
+
+    return written;
+}
+
+//------------------------------------------------------------------------------
+// lê o grafo em 'path' com 'n_threads' threads (0 para usar le_grafo()) e devolve
+// o tempo gasto em segundos
+double time_load(const char* path, unsigned int n_threads, unsigned int* v, unsigned int* e)
+{
+    double start = now();
+    grafo* g;
+
+    if (n_threads == 0) {
+        FILE* f = fopen(path, "r");
+        if (!f)
+            return -1;
+        g = le_grafo(f);
+        fclose(f);
+    } else
+        g = le_grafo_arquivo_paralelo(path, n_threads);
+
+    double elapsed = now() - start;
+
+    if (!g)
+        return -1;
+
+    *v = n_vertices(g);
+    *e = n_arestas(g);
+    destroi_grafo(g);
+
+    return elapsed;
+}
+
+//------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    unsigned long n_lines = (argc > 1) ? strtoul(argv[1], NULL, 10) : 2000000;
+    long n_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    unsigned int max_threads = (argc > 2) ? (unsigned int)atoi(argv[2])
+                                          : (unsigned int)(n_cpus > 0 ? n_cpus : 1);
+    const char* base = (argc > 3) ? argv[3] : "exemplos/cidades.dot";
+    char path[] = "/tmp/bench_leituraXXXXXX";
+    unsigned int v, e, v1, e1;
+    double t, t1;
+    FILE* out;
+
+    if (!(out = create_temp(path)))
+        return 1;
+    if (!finish_temp(out, path, replicate(base, out, n_lines) != 0)) {
+        fprintf(stderr, "nao foi possivel ler %s ou escrever %s\n", base, path);
+        return 1;
+    }
+
+    printf("leitura,threads,segundos,aceleracao,vertices,arestas\n");
+
+    if (((t = time_load(path, 0, &v, &e)) < 0) || ((t1 = time_load(path, 1, &v1, &e1)) < 0)) {
+        fprintf(stderr, "nao foi possivel ler %s\n", path);
+        unlink(path);
+        return 1;
+    }
+    printf("le_grafo,1,%.3f,-,%u,%u\n", t, v, e);
+    printf("le_grafo_arquivo_paralelo,1,%.3f,1.00,%u,%u\n", t1, v1, e1);
+
+    for (unsigned int n = 2; n <= max_threads; n *= 2) {
+        if ((t = time_load(path, n, &v, &e)) < 0) {
+            fprintf(stderr, "nao foi possivel ler %s com %u threads\n", path, n);
+            unlink(path);
+            return 1;
+        }
+        printf("le_grafo_arquivo_paralelo,%u,%.3f,%.2f,%u,%u\n", n, t, t1 / t, v, e);
+        if ((v != v1) || (e != e1))
+            fprintf(stderr, "resultado diferente com %u threads\n", n);
+    }
+
+    unlink(path);
+
+    return 0;
+}
@@ -0,0 +1,146 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "bench_util.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+static unsigned long long random_state = 88172645463325252ull;
+
+//------------------------------------------------------------------------------
+// devolve o tempo do relógio monotônico em segundos
+double now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+//------------------------------------------------------------------------------
+// reinicia a sequência de next_random() com a semente 'seed'
+void seed_random(unsigned long long seed)
+{
+    // o xorshift não sai do estado 0
+    random_state = seed ? seed : 88172645463325252ull;
+}
+
+//------------------------------------------------------------------------------
+// devolve o próximo número da sequência pseudoaleatória (xorshift64*)
+unsigned long next_random(void)
+{
+    random_state ^= random_state >> 12;
+    random_state ^= random_state << 25;
+    random_state ^= random_state >> 27;
+
+    return (unsigned long)((random_state * 0x2545f4914f6cdd1dull) >> 32);
+}
+
+//------------------------------------------------------------------------------
+// escreve em 'out' um caminho com 'm' arestas
+int write_path(FILE* out, unsigned long m)
+{
+    fprintf(out, "caminho\n");
+    for (unsigned long i = 1; i <= m; i++)
+        fprintf(out, "p%lu -- p%lu\n", i - 1, i);
+    if (m == 0)
+        fprintf(out, "p0\n");
+
+    return !ferror(out);
+}
+
+//------------------------------------------------------------------------------
+// escreve em 'out' uma grade quadrada com cerca de 'm' arestas
+int write_grid(FILE* out, unsigned long m)
+{
+    unsigned long side = 1;
+
+    while (2 * side * (side - 1) < m)
+        side++;
+
+    return write_square_grid(out, side);
+}
+
+//------------------------------------------------------------------------------
+// escreve em 'out' uma grade com 'side' x 'side' vértices
+int write_square_grid(FILE* out, unsigned long side)
+{
+    fprintf(out, "grade\n");
+    for (unsigned long i = 0; i < side; i++) {
+        for (unsigned long j = 0; j < side; j++) {
+            if (j + 1 < side)
+                fprintf(out, "g%lu_%lu -- g%lu_%lu\n", i, j, i, j + 1);
+            if (i + 1 < side)
+                fprintf(out, "g%lu_%lu -- g%lu_%lu\n", i, j, i + 1, j);
+        }
+    }
+    if (side == 1)
+        fprintf(out, "g0_0\n");
+
+    return !ferror(out);
+}
+
+//------------------------------------------------------------------------------
+// escreve em 'out' um grafo aleatório G(n, m) com grau médio 8 e pesos de 1 a 100
+int write_gnm(FILE* out, unsigned long m)
+{
+    unsigned long n = m / 4 + 2;
+
+    fprintf(out, "aleatorio\n");
+    for (unsigned long i = 0; i < m; i++)
+        fprintf(out, "r%lu -- r%lu %lu\n", next_random() % n, next_random() % n,
+            next_random() % 100 + 1);
+
+    return !ferror(out);
+}
+
+//------------------------------------------------------------------------------
+// cria o arquivo temporário de modelo 'path' e o devolve aberto para escrita
+FILE* create_temp(char* path)
+{
+    FILE* out;
+    int fd;
+
+    if ((fd = mkstemp(path)) < 0) {
+        fprintf(stderr, "nao foi possivel criar arquivo temporario\n");
+        return NULL;
+    }
+    if (!(out = fdopen(fd, "w"))) {
+        fprintf(stderr, "nao foi possivel criar arquivo temporario\n");
+        close(fd);
+        unlink(path);
+        return NULL;
+    }
+
+    return out;
+}
+
+//------------------------------------------------------------------------------
+// fecha o arquivo temporário 'out', removendo-o se 'ok' é 0 ou a escrita falhou
+int finish_temp(FILE* out, const char* path, int ok)
+{
+    ok = ok && !ferror(out);
+    ok = !fclose(out) && ok;
+    if (!ok)
+        unlink(path);
+
+    return ok;
+}
+
+//------------------------------------------------------------------------------
+// escreve com 'write' um grafo de cerca de 'm' arestas num arquivo temporário
+int write_temp(char* path, int (*write)(FILE* out, unsigned long m), unsigned long m)
+{
+    FILE* out;
+
+    if (!(out = create_temp(path)))
+        return 0;
+    if (!finish_temp(out, path, write(out, m))) {
+        fprintf(stderr, "nao foi possivel escrever %s\n", path);
+        return 0;
+    }
+
+    return 1;
+}
@@ -0,0 +1,64 @@
+#ifndef BENCH_UTIL_H
+#define BENCH_UTIL_H
+#include <stdio.h>
+
+//------------------------------------------------------------------------------
+// funções comuns aos programas de benchmark: relógio, números pseudoaleatórios,
+// geradores de grafos e arquivos temporários
+
+//------------------------------------------------------------------------------
+// devolve o tempo do relógio monotônico em segundos
+
+double now(void);
+
+//------------------------------------------------------------------------------
+// reinicia a sequência de next_random() com a semente 'seed', então os grafos
+// gerados depois dela são sempre os mesmos
+
+void seed_random(unsigned long long seed);
+
+//------------------------------------------------------------------------------
+// devolve o próximo número da sequência pseudoaleatória (xorshift64*)
+
+unsigned long next_random(void);
+
+//------------------------------------------------------------------------------
+// geradores de grafos: escrevem um grafo em 'out', no formato de le_grafo(), e
+// devolvem 0 se a escrita falhou
+//
+// write_path escreve um caminho com 'm' arestas
+//
+// write_grid escreve uma grade quadrada com cerca de 'm' arestas e
+// write_square_grid uma grade com 'side' x 'side' vértices
+//
+// write_gnm escreve um grafo aleatório G(n, m) com grau médio 8 e pesos de 1 a
+// 100; os vértices sem arestas não aparecem
+
+int write_path(FILE* out, unsigned long m);
+int write_grid(FILE* out, unsigned long m);
+int write_square_grid(FILE* out, unsigned long side);
+int write_gnm(FILE* out, unsigned long m);
+
+//------------------------------------------------------------------------------
+// cria um arquivo temporário com o nome dado pelo modelo 'path', terminado em
+// XXXXXX, que recebe o nome criado, e o devolve aberto para escrita, ou NULL
+
+FILE* create_temp(char* path);
+
+//------------------------------------------------------------------------------
+// fecha o arquivo temporário 'out' de nome 'path'; se 'ok' é 0 ou a escrita
+// falhou, o arquivo é removido
+//
+// devolve 1 se o arquivo foi escrito e 0 caso contrário
+
+int finish_temp(FILE* out, const char* path, int ok);
+
+//------------------------------------------------------------------------------
+// escreve com 'write' o grafo de cerca de 'm' arestas num arquivo temporário
+// criado com o modelo 'path', que recebe o nome criado
+//
+// devolve 1 em caso de sucesso e 0 em caso de erro, com uma mensagem em stderr
+
+int write_temp(char* path, int (*write)(FILE* out, unsigned long m), unsigned long m);
+
+#endif
@@ -1,142 +1,787 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include "grafo.h"
+#include <fcntl.h>
 #include <limits.h>
+#include <pthread.h>
 #include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
 
 #define STARTING_VERT_NUM 36
 #define STARTING_CUT_LIST_NUM 36
+#define STARTING_NAME_TABLE_SIZE 64 // must be a power of two
+#define STARTING_EDGE_NUM 64
+#define EMPTY_SLOT UINT_MAX
+#define NOT_IN_HEAP UINT_MAX
+#define ARENA_CHUNK_SIZE (64 * 1024)
+#define ARENA_ALIGN 16
+#define MIN_CHUNK_BYTES (256 * 1024) // smallest piece of input given to a parsing thread
+#define DIAL_MAX_WEIGHT 255 // largest edge weight handled by Dial's bucket queue
+#define RADIX_BUCKETS 33 // one bucket per bit of a distance, plus one for the smallest
+#define MIN_THREAD_VERTS 64 // smallest number of vertices per thread when computing diameters
+#define SOURCE_BATCH 8 // number of sources a diameter thread takes at a time
+#define MIN_THREAD_ADJ (1 << 16) // smallest number of adjacency entries per labeling thread
+#define LINK_BATCH 1024 // number of vertices a labeling thread takes at a time
+#define BFS_ALPHA 14 // a BFS goes bottom-up when the frontier has 1/BFS_ALPHA of the unseen edges
+#define BFS_BETA 24 // and at least 1/BFS_BETA of the vertices, and top-down again below that
+#define CALCULA_BLOCOS 16u // blocks_t describes the current graph (internal to compute)
+#define NO_BLOCK UINT_MAX
+#define NO_PARENT UINT_MAX
+#define BC_BLOCK 0x80000000u // marks a block among the nodes of the block-cut forest
+#define SNAPSHOT_MAGIC "GRAFOBIN"
+#define SNAPSHOT_VERSION 2
+#define SNAPSHOT_SEED 0xcbf29ce484222325ull
+
+// sections of a snapshot file, in the order they are written
+#define SNAP_NAME 0
+#define SNAP_NAME_OFF 1 // offset of the name of each vertex in SNAP_STRINGS
+#define SNAP_SLOTS 2
+#define SNAP_ADJ_OFF 3
+#define SNAP_ADJ 4
+#define SNAP_ADJ_W 5
+#define SNAP_COMPONENT 6
+#define SNAP_COLOR 7
+#define SNAP_ODD_CYCLE 8
+#define SNAP_VERTEX_CUT 9
+#define SNAP_EDGE_CUT 10
+#define SNAP_DIAMETROS 11
+#define SNAP_STRINGS 12
+#define SNAP_SECTIONS 13
+
+// counters of grafo_stats, compiled only with -DGRAFO_STATS; without it the macros and
+// the counter fields are gone
+#ifdef GRAFO_STATS
+#define STATS_INC(x) ((x)++)
+#define STATS_ADD(x, n) ((x) += (n))
+#define STATS_START(t) double t = stats_now()
+#define STATS_STOP(x, t) ((x) += stats_now() - (t))
+#define STATS_PEAK(g, extra) stats_peak((g), (extra))
+#define STATS_HEAP(g, h) stats_heap((g), (h))
+#else
+#define STATS_INC(x) ((void)0)
+#define STATS_ADD(x, n) ((void)0)
+#define STATS_START(t) ((void)0)
+#define STATS_STOP(x, t) ((void)0)
+#define STATS_PEAK(g, extra) ((void)0)
+#define STATS_HEAP(g, h) ((void)0)
+#endif
+
+// kinds of the items of a uint_list, which tell how they are sorted and written
+#define ITEM_VERTEX 0 // a vertex index, written as its name
+#define ITEM_EDGE 1 // two vertex indices, written as their names separated by a space
+#define ITEM_NUMBER 2 // a number, written in decimal
 
 typedef unsigned int uint;
 
-struct neighbor;
-struct vertice;
-
-typedef struct neighbor {
-    uint idx; // indice do vizinho na lista de vertices do grafo
-    uint weight; // peso da aresta ate o vizinho
-    struct neighbor* next;
-} neighbor;
-
-typedef struct vertice {
-    char* name;
-    struct neighbor* n_list; // lista de vizinhos
-    uint n_num; // numero de vizinhos
-    struct vertice* pai;
-    uint componente;
-    uint dist;
-    uint lowpoint;
-    uint nivel;
-    int estado;
-} vertice;
-
-typedef struct str_list {
-    char** str;
+struct arena_chunk;
+
+// block of memory from which the arena hands out allocations
+typedef struct arena_chunk {
+    struct arena_chunk* next;
+    size_t size; // bytes available in data
+    size_t used;
+    char* data;
+} arena_chunk;
+
+// bump allocator for everything that lives as long as the graph
+// memory is only released all at once, by arena_free
+typedef struct arena {
+    arena_chunk* head;
+    size_t used; // bytes handed out so far, with the padding of aligned requests
+} arena;
+
+// open addressing hash table (linear probing) indexing the vertices by name
+// each slot keeps the index of the vertex in the graph's vertex list and the
+// hash of its name, the name itself is kept in the graph's arena
+typedef struct name_slot {
+    uint idx;
+    uint hash;
+} name_slot;
+
+typedef struct name_table {
+    name_slot* slots;
+    uint capacity; // power of two
+    uint used;
+} name_table;
+
+// edge read from the input, kept until the adjacency is built
+typedef struct edge {
+    uint a;
+    uint b;
+    uint weight;
+} edge;
+
+typedef struct edge_list {
+    edge* e;
     uint size;
     uint max;
-} str_list;
+} edge_list;
+
+// piece of a line of the input
+typedef struct token {
+    const char* str;
+    size_t len;
+} token;
+
+// state of a thread parsing a piece of the input. Names are interned in a table local
+// to the thread, with ids given in order of first appearance in the piece, and edges are
+// kept with those local ids until the pieces are merged
+typedef struct chunk_parse {
+    const char* start;
+    const char* end;
+    token* names; // local id -> name, pointing inside the input
+    uint* hashes;
+    uint n_names;
+    uint max_names;
+    name_slot* slots; // local table, the slots keep local ids
+    uint capacity;
+    edge* edges;
+    uint n_edges;
+    uint max_edges;
+    uint* map; // local id -> index of the vertex in the graph
+    edge* out; // where the edges go in the graph's staged edge list
+    int ok;
+#ifdef GRAFO_STATS
+    unsigned long long n_lines;
+    unsigned long long n_lookups;
+#endif
+} chunk_parse;
+
+// biconnected structure of the graph, found by set_cut along with the cuts
+// self-loops belong to no block
+typedef struct blocks {
+    uint n; // number of blocks
+    // the edges of block b are {edges[2k], edges[2k + 1]}, edge_off[b] <= k < edge_off[b + 1]
+    uint* edge_off;
+    uint* edges;
+    uint* top; // vertex of block b closest to the root of the DFS
+    // the cut vertices of block b are cuts[cut_off[b]] ... cuts[cut_off[b + 1] - 1]
+    uint* cut_off;
+    uint* cuts;
+    uint n_2ecc; // number of 2-edge-connected components
+    uint* comp_2ecc; // 2-edge-connected component of each vertex
+} blocks_t;
+
+// union-find over the vertices kept by adiciona_vertice and adiciona_aresta, with the
+// parity of each vertex relative to its parent, so the number of components and whether
+// the graph is bipartite follow each inserted edge without a new search
+typedef struct dsu {
+    uint* parent; // NULL until the first insertion
+    unsigned char* rank;
+    unsigned char* parity; // 1 if the vertex and its parent are on different sides
+    uint* size; // vertices in the set of each root
+    uint n; // vertices in the structure
+    uint max;
+    uint sets;
+    uint odd; // 1 once an edge closed an odd cycle
+} dsu_t;
+
+// block-cut forest kept by adiciona_aresta once the cuts are known, so the cut vertices
+// and bridges follow each inserted edge without a new search. Vertices and blocks
+// alternate in the trees: the parent of a block is its vertex closest to the root and
+// the other vertices of the block are its children. Blocks joined by an edge are merged
+// in a union-find, so each block is represented by the root of its set
+//
+// a vertex is a cut vertex if it is in two blocks or more, and a block with one child
+// vertex is a bridge
+typedef struct bc_forest {
+    uint* up; // block of which each vertex is a child, NO_BLOCK for the roots
+    uint* n_blocks; // child blocks of each vertex
+    uint* mark; // last search that went through each vertex
+    uint n_v;
+    uint max_v;
+    uint* block; // union-find parent of each block
+    uint* top; // parent of each block, at the root of its set
+    uint* n_verts; // child vertices of each block, at the root of its set
+    uint* block_mark;
+    uint n_b;
+    uint max_b;
+    uint search; // number of the last search for a common ancestor
+    uint stale; // 1 if vertex_cut and edge_cut do not follow the forest yet
+} bc_forest;
+
+// working arrays of the DFS of set_cut, allocated once for the whole graph
+typedef struct cut_search {
+    uint* stack; // DFS stack
+    uint* next; // position in the adjacency of v of the next neighbor to visit
+    uint* parent; // parent of each vertex in the DFS tree, NO_PARENT for the roots
+    uint* level; // depth of each vertex in the DFS tree
+    uint* low; // lowpoint of each vertex, the smallest level it reaches by a back edge
+    unsigned char* state; // 0 not visited, 1 in the stack, 2 done
+    unsigned char* is_cut; // marks the vertices already in the vertex cut
+    uint* edge_stack; // edges of the blocks not yet closed, as pairs of vertices
+    uint n_edges;
+    uint* vert_stack; // vertices of the 2-edge-connected components not yet closed
+    uint n_verts;
+} cut_search;
+
+// header of the file written by salva_grafo_binario. The file is mapped and used in
+// place, so every section is aligned to 8 bytes and holds the arrays as they are in memory
+typedef struct snapshot_header {
+    char magic[8];
+    uint version;
+    uint valid; // CALCULA_* flags of the results in the file
+    uint v_num;
+    uint e_num;
+    uint n_adj; // entries of adj and adj_w
+    uint name_capacity;
+    uint min_w; // smallest and largest edge weights, to pick the shortest path kernel
+    uint max_w;
+    uint name_len;
+    uint n_componentes;
+    uint bipartite;
+    uint odd_len;
+    uint n_vertex_cut;
+    uint n_edge_cut; // two entries per bridge
+    uint n_diametros;
+    unsigned long long strings_len;
+    unsigned long long size; // bytes in the file
+    unsigned long long checksum; // of the whole file, taken with this field zeroed
+    unsigned long long off[SNAP_SECTIONS]; // where each section starts in the file
+} snapshot_header;
+
+typedef struct snapshot_writer {
+    FILE* f;
+    unsigned long long checksum;
+    unsigned char word[8]; // bytes written but not yet in the checksum
+    uint n_bytes;
+    int ok;
+} snapshot_writer;
+
+// list of the items of a result: vertex indices, pairs of them or numbers. Names are
+// only looked up when the result is given as text
+typedef struct uint_list {
+    uint* v;
+    uint size; // entries in v, two per item of kind ITEM_EDGE
+    uint max;
+    uint sorted; // 1 if v is already in output order, kept for the next query
+} uint_list;
+
+// an item of kind ITEM_VERTEX or ITEM_EDGE with the names it is sorted by
+typedef struct named_item {
+    const char* name[2]; // name[1] is NULL for a vertex
+    uint id[2];
+    uint len; // length of name[0], for edges
+} named_item;
+
+// direction-optimizing breadth-first search (Beamer et al.): each level is expanded
+// top-down, from the frontier to its neighbors, or bottom-up, from each vertex not yet
+// seen to a neighbor in the frontier, stopping at the first one found. On graphs of
+// small diameter the bottom-up steps skip most of the edges of the largest levels
+//
+// the vertices seen are the ones with a level, which carries over from one search to the
+// next, so consecutive searches from the vertices not yet seen label the components of
+// the graph. The top-down steps only look at the levels, as the plain queue of a BFS
+// does; the bitmap of the vertices seen is brought up to date from the queue when a
+// bottom-up step needs it, so searches of large diameter do not pay for it
+typedef struct bfs {
+    uint* level; // distance from the root of each vertex seen, UINT_MAX for the others
+    uint* queue; // vertices seen, level by level
+    unsigned long long* seen; // bitmap of b->queue[0 .. n_marked - 1], with the bits past n set
+    unsigned long long* frontier; // bitmap of the level expanded by a bottom-up step
+    unsigned long long unseen_edges; // adjacency entries of the vertices not yet seen
+    uint n_queued;
+    uint n_marked; // vertices of the queue already in 'seen'
+    uint bottom_up; // steps of the searches so far that went bottom-up
+    uint odd[2]; // an edge inside a level, found by a top-down step, or UINT_MAX
+    uint n;
+    uint n_words; // words of each bitmap
+#ifdef GRAFO_STATS
+    unsigned long long scanned; // adjacency entries scanned
+#endif
+} bfs_t;
+
+// priority queue of vertex indices keyed by their distance, used by the shortest path
+// kernels. It holds room for every vertex of the graph and is reused by consecutive runs
+//
+// the indexed min-heap uses items and pos; the bucket queues (Dial's and the radix heap)
+// keep a doubly linked list of vertices per bucket, with pos holding the bucket of each
+// vertex; with unit weights the BFS of bfs_max_dist keeps its levels in dist and its queue
+// in reached, and needs no queue of its own
+typedef struct heap {
+    uint* items;
+    uint* pos; // position of each vertex in items (or its bucket), NOT_IN_HEAP if not there
+    uint* dist; // distance of each vertex from the source, UINT_MAX if not reached
+    uint* reached; // vertices reached by the current run
+    uint* next; // links of the bucket lists
+    uint* prev;
+    uint* heads; // first vertex of each bucket, NOT_IN_HEAP if it is empty
+    uint n_buckets;
+    uint base; // smallest distance a vertex in the bucket queue may have
+    uint n_reached;
+    uint size;
+    uint capacity;
+    bfs_t bfs; // search of bfs_max_dist, on dist and reached; allocated by its first run
+#ifdef GRAFO_STATS
+    unsigned long long pushes;
+    unsigned long long pops;
+    unsigned long long decreases;
+    unsigned long long relaxed; // adjacency entries scanned by the kernels
+    size_t bytes;
+#endif
+} heap_t;
 
 struct grafo {
+    arena mem; // names and results computed from the graph
     char* name;
-    vertice* v;
+    // the names are apart from the state of the searches, kept in arrays of their own
+    // indexed by vertex, so the searches only bring into cache the fields they use
+    char** v_name; // name of each vertex, in the arena or in the snapshot
     uint v_num;
     uint max_v_num;
+    name_table names;
+    edge_list staged; // edges read but not yet in the adjacency arrays
+    // adjacency in compressed sparse row layout: the neighbors of vertex v are
+    // adj[adj_off[v]] ... adj[adj_off[v + 1] - 1], sorted by index, and the weight
+    // of the edge to adj[k] is adj_w[k]
+    uint* adj_off;
+    uint* adj;
+    uint* adj_w;
+    uint adj_v_num; // vertices covered by adj_off
+    uint e_num;
+    uint n_threads; // threads used by the analyses, 0 for one per processor
+    uint path_mode; // CAMINHOS_* choice of shortest path kernel
+    uint n_buckets; // buckets needed by the queue of max_dist, 0 if it uses the heap
+    uint (*max_dist)(grafo* g, uint r, heap_t* h); // shortest path kernel for the weights
+    uint diameter_mode; // DIAMETRO_* algorithm used by set_diameters
+    uint n_sssp; // Dijkstra runs made by the last set_diameters
+    uint valid; // CALCULA_* flags of the results already computed
     uint n_componentes;
-    str_list vertex_cut;
-    str_list edge_cut;
-    str_list diametros;
+    uint* component; // component of each vertex, numbered from 1
+    uint bipartite;
+    unsigned char* color; // side of each vertex in a 2-coloring by BFS level parity
+    uint* odd_cycle; // vertices of an odd cycle, if g is not bipartite (malloc'd)
+    uint odd_len;
+    uint_list vertex_cut; // ITEM_VERTEX
+    uint_list edge_cut; // ITEM_EDGE
+    uint_list diametros; // ITEM_NUMBER
+    blocks_t blocks;
+    dsu_t dsu;
+    bc_forest bc; // up is NULL until an edge is inserted after the cuts are computed
+    char* snapshot; // file mapped by carrega_grafo_binario, NULL if none
+    size_t snapshot_len;
+    uint shared; // 1 while names.slots and the adjacency arrays point into the snapshot
+#ifdef GRAFO_STATS
+    grafo_stats stats;
+#endif
 };
 
-typedef struct queue {
-    void* elem;
-    struct queue* prev;
-    struct queue* next;
-} queue_t;
+// state of a thread computing eccentricities for set_diameters. The threads take
+// sources from a shared cursor and keep the largest eccentricity of each component
+typedef struct diameter_worker {
+    grafo* g;
+    uint* cursor; // next source to be taken, shared by all threads
+    uint* diametro; // largest eccentricity found in each component
+    heap_t* h;
+} diameter_worker;
 
-typedef struct heap {
-    vertice** items;
-    uint size;
-    uint capacity;
-} heap_t;
+// state of a thread joining the components of the edges of the vertices taken from a
+// shared cursor, in the union-find of label_components
+typedef struct link_worker {
+    grafo* g;
+    uint* cursor; // next vertex to be taken, shared by all threads
+    uint* parent; // union-find shared by all threads, updated with atomic operations
+} link_worker;
 
 // auxiliary functions
-grafo* create_graph(char* name);
-void destroy_neighbor_list(neighbor* head);
-neighbor* add_neighbor(grafo* g, uint v_idx, uint neigh_idx, uint weight);
-long long int add_vert(vertice** V, uint* size, uint* max, char* name);
-long long int add_graph_vert(grafo* g, char* name);
-void add_graph_edge(grafo* g, char* name_a, char* name_b, uint weight);
-long long int search_vert(vertice* V, uint size, char* name);
-neighbor* create_neighbor(uint idx, uint weight);
-int parse_line(char* line, char** x, char** y, int* p);
+grafo* create_graph(const char* name, size_t len);
+void stage_edge(grafo* g, uint a, uint b, uint weight);
+void build_adjacency(grafo* g);
+void choose_kernel(grafo* g);
+void set_kernel(grafo* g, uint min_w, uint max_w);
+int comp_adj_key(const void* a, const void* b);
+long long int add_vert(grafo* g, const char* name, size_t len);
+uint intern_vert(grafo* g, const char* name, size_t len, uint hash);
+void add_graph_edge(grafo* g, token a, token b, uint weight);
+long long int search_vert(grafo* g, const char* name, size_t len);
+uint hash_name(const char* name, size_t len);
+name_slot* find_slot(grafo* g, const char* name, size_t len, uint hash);
+void grow_name_table(grafo* g);
+int parse_line(const char* line, const char* end, token* x, token* y, uint* p);
+int add_line(grafo* g, const char* line, const char* end);
+void compute(grafo* g, uint what);
 int get_valid_string(char* line, int size, FILE* f);
-void set_states(vertice* V, uint size, int state);
-void mininumDistances(grafo* g, vertice* v);
+grafo* read_mapped(const char* data, const char* end, uint n_threads);
+void* parse_chunk(void* arg);
+void* translate_chunk(void* arg);
+uint chunk_intern(chunk_parse* c, token t);
+void run_threads(void* (*func)(void*), void* args, size_t arg_size, uint n);
+uint thread_count(uint n_threads);
 uint set_components(grafo* g);
-void low_point(grafo* g, vertice* r, str_list* vertex_cut, str_list* edge_cut);
+uint label_components(grafo* g, uint n_threads);
+void* link_thread(void* arg);
+void set_odd_cycle(grafo* g, const uint* level, uint a, uint b);
+uint bfs_up(grafo* g, const uint* level, uint v);
+void low_point(grafo* g, uint root, cut_search* s);
+void close_block(grafo* g, uint top, uint v, cut_search* s);
+void close_2ecc(grafo* g, uint v, cut_search* s);
+void set_block_cuts(grafo* g, const unsigned char* is_cut);
+void free_blocks(blocks_t* b);
 void set_cut(grafo* g);
-char* create_edge_name(const char* name1, const char* name2);
-int comp_name(const void* a, const void* b);
-int comp_number(const void* a, const void* b);
-char* create_str_from_str_list(char** str, uint size, int (*func)(const void* a, const void* b));
-char** add_name(str_list* list, char* name);
-void dijkstra_max_dist(grafo* g, vertice* r);
+int comp_named(const void* a, const void* b);
+int comp_uint(const void* a, const void* b);
+void sort_items(grafo* g, uint_list* list, uint kind);
+size_t item_text(grafo* g, const uint* item, uint kind, char* out);
+char* create_str_from_items(grafo* g, uint_list* list, uint kind);
+uint write_items(FILE* f, grafo* g, uint_list* list, uint kind);
+uint visit_items(grafo* g, uint_list* list, uint kind,
+    int (*visita)(const char* item, void* dados), void* dados);
+uint copy_items(grafo* g, uint_list* list, uint kind, uint* out);
+void add_uint(uint_list* list, uint x);
+uint dijkstra_max_dist(grafo* g, uint r, heap_t* h);
+uint bfs_max_dist(grafo* g, uint r, heap_t* h);
+uint dial_max_dist(grafo* g, uint r, heap_t* h);
+uint radix_max_dist(grafo* g, uint r, heap_t* h);
+void* diameter_thread(void* arg);
+void all_sources_diameters(grafo* g, uint* diametro);
+void bounded_diameters(grafo* g, uint* diametro);
+void sweep_diameters(grafo* g, uint sweeps, uint* lower, uint* upper);
+void group_by_component(grafo* g, uint* order, uint* start);
 void set_diameters(grafo* g);
-void destroy_str_list(str_list list);
-
-// queue functions
-void queue_append(queue_t** queue, void* elem);
-void destroy_queue(queue_t** queue);
-void* queue_pop(queue_t** queue);
+void destroy_uint_list(uint_list list);
+
+// vertex ordering functions
+void bfs_order(grafo* g, uint* order, uint rcm);
+void degree_order(grafo* g, uint* order);
+void renumber_vertices(grafo* g, const uint* order);
+
+// breadth-first search functions
+void bfs_init(bfs_t* b, grafo* g, uint* level, uint* queue);
+void bfs_reset(bfs_t* b, grafo* g);
+void bfs_free(bfs_t* b);
+uint bfs_run(grafo* g, bfs_t* b, uint root);
+uint bfs_reach(grafo* g, bfs_t* b, uint v, uint level);
+unsigned long long bfs_top_down(grafo* g, bfs_t* b, uint* start, uint* level);
+unsigned long long bfs_bottom_up(grafo* g, bfs_t* b, uint start, uint end, uint level);
+
+// union-find functions
+void dsu_grow(grafo* g);
+uint dsu_find(dsu_t* d, uint v, uint* parity);
+void dsu_union(dsu_t* d, uint a, uint b);
+uint uf_find(uint* parent, uint v);
+void uf_link(uint* parent, uint a, uint b);
+
+// block-cut forest functions
+void bc_build(grafo* g);
+void bc_grow(grafo* g);
+void bc_free(bc_forest* f);
+uint bc_new_block(bc_forest* f, uint top);
+uint bc_find(bc_forest* f, uint b);
+uint bc_union(bc_forest* f, uint a, uint b);
+uint bc_parent(bc_forest* f, uint x);
+uint bc_visit(bc_forest* f, uint x);
+void bc_evert(bc_forest* f, uint v);
+uint bc_collapse_path(bc_forest* f, uint x, uint l, uint* m);
+void bc_insert(grafo* g, uint a, uint b);
+void bc_cut_lists(grafo* g);
+
+// snapshot functions
+void snapshot_layout(snapshot_header* h);
+uint snapshot_check(const snapshot_header* h, size_t size);
+uint snapshot_indices(const snapshot_header* h, const char* map);
+grafo* load_snapshot(char* map, size_t size);
+void detach_snapshot(grafo* g);
+unsigned long long snapshot_header_sum(const snapshot_header* h, unsigned long long sum);
+unsigned long long snapshot_mix(unsigned long long h, unsigned long long x);
+void snapshot_write(snapshot_writer* w, const void* data, size_t len);
+void snapshot_pad(snapshot_writer* w);
+void snapshot_items(uint_list* list, const char* data, uint n);
+
+// counters of grafo_stats
+#ifdef GRAFO_STATS
+double stats_now(void);
+void stats_peak(grafo* g, size_t extra);
+void stats_heap(grafo* g, const heap_t* h);
+void stats_dump(grafo* g);
+size_t stats_chunks(const chunk_parse* chunks, uint n);
+#endif
+
+// arena functions
+void* arena_alloc(arena* a, size_t size);
+void* arena_alloc_bytes(arena* a, size_t size, size_t align);
+char* arena_strdup(arena* a, const char* str, size_t len);
+void arena_free(arena* a);
 
 // min-heap functions
-heap_t* heap_create(void);
+heap_t* heap_create(uint capacity, uint n_buckets);
 void heap_free(heap_t* h);
-void heap_append_vertex(heap_t* h, vertice* v);
-vertice* heap_pop_vertex(heap_t* h);
+void heap_append_vertex(heap_t* h, uint v);
+uint heap_pop_vertex(heap_t* h);
+void heap_decrease_key(heap_t* h, uint v);
 void heapify_up(heap_t* h, uint idx);
 void heapify_down(heap_t* h, uint idx);
-void heapify_vertex_up(heap_t* h, vertice* v);
-void swap(vertice** a, vertice** b);
+
+// queues of the specialized kernels
+void bucket_link(heap_t* h, uint v, uint b);
+void bucket_unlink(heap_t* h, uint v);
+void dial_push(heap_t* h, uint v);
+uint dial_pop(heap_t* h);
+void dial_decrease_key(heap_t* h, uint v);
+uint radix_bucket(heap_t* h, uint key);
+void radix_push(heap_t* h, uint v);
+uint radix_pop(heap_t* h);
+void radix_decrease_key(heap_t* h, uint v);
 
 //------------------------------------------------------------------------------
 // lê um grafo de f e o devolve
 grafo* le_grafo(FILE* f)
 {
-    char *g_name, *name_x, *name_y, line[2048];
-    int res;
-    uint p;
+    char line[2048];
+    size_t len;
+    STATS_START(start);
 
     if (!get_valid_string(line, 2048, f))
         return NULL;
-    line[strlen(line) - 1] = '\0';
+    len = strlen(line);
+    if (line[len - 1] == '\n')
+        len--;
 
-    // alloca e copia nome
-    if (!(g_name = malloc(sizeof(char) * strlen(line) + 1)))
+    grafo* g = create_graph(line, len);
+    if (!g)
         return NULL;
-    strcpy(g_name, line);
-
-    grafo* g = create_graph(g_name);
 
     while (1) {
         if (!get_valid_string(line, 2048, f))
             break;
 
-        res = parse_line(line, &name_x, &name_y, (int*)&p);
-
-        if (res == 0) {
+        if (!add_line(g, line, line + strlen(line))) {
             destroi_grafo(g);
             return NULL;
-        } else if (res > 1) {
-            add_graph_edge(g, name_x, name_y, p);
-        } else if (res == 1) {
-            add_graph_vert(g, name_x);
         }
     }
 
-    set_cut(g);
-    set_diameters(g);
+    build_adjacency(g);
+    STATS_STOP(g->stats.leitura, start);
+
+    return g;
+}
+
+//------------------------------------------------------------------------------
+// lê um grafo de f e o devolve, calculando de antemão os resultados indicados
+// em 'opcoes'
+grafo* le_grafo_opcoes(FILE* f, unsigned int opcoes)
+{
+    grafo* g = le_grafo(f);
+
+    if (g)
+        compute(g, opcoes);
+
+    return g;
+}
+
+//------------------------------------------------------------------------------
+// calcula os resultados de g indicados em 'opcoes' que ainda não foram calculados
+void pre_calcula(grafo* g, unsigned int opcoes) { compute(g, opcoes); }
+
+//------------------------------------------------------------------------------
+// lê um grafo do arquivo de nome 'caminho' e o devolve
+// o arquivo é mapeado em memória e lido sem cópias intermediárias
+grafo* le_grafo_arquivo(const char* caminho) { return le_grafo_arquivo_paralelo(caminho, 1); }
+
+//------------------------------------------------------------------------------
+// lê um grafo do arquivo de nome 'caminho' usando 'n_threads' threads e o devolve
+// se 'n_threads' é 0, usa uma thread por processador disponível
+grafo* le_grafo_arquivo_paralelo(const char* caminho, unsigned int n_threads)
+{
+    struct stat st;
+    grafo* g;
+    void* map;
+    int fd;
+    STATS_START(start);
+
+    if ((fd = open(caminho, O_RDONLY)) < 0)
+        return NULL;
+
+    if ((fstat(fd, &st) < 0) || (st.st_size == 0)) {
+        close(fd);
+        return NULL;
+    }
+
+    map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+        return NULL;
+    posix_madvise(map, (size_t)st.st_size, POSIX_MADV_SEQUENTIAL);
+
+    g = read_mapped(map, (const char*)map + st.st_size, thread_count(n_threads));
+
+    munmap(map, (size_t)st.st_size);
+
+    if (g) {
+        build_adjacency(g);
+        STATS_STOP(g->stats.leitura, start);
+    }
+
+    return g;
+}
+
+//------------------------------------------------------------------------------
+// grava g no arquivo de nome 'caminho' no formato binário lido por
+// carrega_grafo_binario(), com os resultados já calculados
+// devolve 1 em caso de sucesso e 0 em caso de erro
+unsigned int salva_grafo_binario(grafo* g, const char* caminho)
+{
+    snapshot_header h;
+    snapshot_writer w;
+    unsigned long long next = 0;
+    uint min_w = UINT_MAX, max_w = 0;
+    char* tmp;
+    int fd;
+
+    if ((g->staged.size > 0) || (g->adj_v_num < g->v_num))
+        build_adjacency(g);
+    if (g->bc.stale)
+        bc_cut_lists(g);
+
+    for (uint k = 0; k < g->adj_off[g->v_num]; k++) {
+        if (g->adj_w[k] < min_w)
+            min_w = g->adj_w[k];
+        if (g->adj_w[k] > max_w)
+            max_w = g->adj_w[k];
+    }
+
+    memset(&h, 0, sizeof(snapshot_header));
+    memcpy(h.magic, SNAPSHOT_MAGIC, sizeof(h.magic));
+    h.version = SNAPSHOT_VERSION;
+    h.valid = g->valid
+        & (CALCULA_COMPONENTES | CALCULA_BIPARTIDO | CALCULA_CORTES | CALCULA_DIAMETROS);
+    // the components are saved with their coloring, which label_components does not give
+    if (!(h.valid & CALCULA_BIPARTIDO))
+        h.valid &= ~CALCULA_COMPONENTES;
+    h.v_num = g->v_num;
+    h.e_num = g->e_num;
+    h.n_adj = g->adj_off[g->v_num];
+    h.name_capacity = g->names.capacity;
+    h.min_w = min_w;
+    h.max_w = max_w;
+    h.name_len = (uint)strlen(g->name);
+    if (h.valid & CALCULA_COMPONENTES) {
+        h.n_componentes = g->n_componentes;
+        h.bipartite = g->bipartite;
+        h.odd_len = g->bipartite ? 0 : g->odd_len;
+    }
+    // the lists are saved in output order, so the graph loaded does not sort them again
+    if (h.valid & CALCULA_CORTES) {
+        sort_items(g, &g->vertex_cut, ITEM_VERTEX);
+        sort_items(g, &g->edge_cut, ITEM_EDGE);
+        h.n_vertex_cut = g->vertex_cut.size;
+        h.n_edge_cut = g->edge_cut.size;
+    }
+    if (h.valid & CALCULA_DIAMETROS) {
+        sort_items(g, &g->diametros, ITEM_NUMBER);
+        h.n_diametros = g->diametros.size;
+    }
+
+    // the names go to the string section, referred to by 32 bit offsets
+    for (uint i = 0; i < g->v_num; i++)
+        h.strings_len += strlen(g->v_name[i]) + 1;
+    if (h.strings_len > UINT_MAX)
+        return 0;
+    snapshot_layout(&h);
+
+    // the snapshot is written aside and renamed over 'caminho', so processes that have
+    // the old one mapped keep reading it; the name of the temporary file is unique, in
+    // the directory of 'caminho' for the rename, so concurrent saves do not share it
+    if (!(tmp = malloc(strlen(caminho) + 8)))
+        return 0;
+    strcpy(tmp, caminho);
+    strcat(tmp, ".XXXXXX");
+    if ((fd = mkstemp(tmp)) < 0) {
+        free(tmp);
+        return 0;
+    }
+    if (fchmod(fd, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH) || !(w.f = fdopen(fd, "wb"))) {
+        close(fd);
+        unlink(tmp);
+        free(tmp);
+        return 0;
+    }
+    w.checksum = SNAPSHOT_SEED;
+    w.n_bytes = 0;
+    w.ok = (fwrite(&h, sizeof(snapshot_header), 1, w.f) == 1);
+
+    snapshot_write(&w, g->name, h.name_len + 1);
+    snapshot_pad(&w);
+    for (uint i = 0; i < g->v_num; i++) {
+        uint off = (uint)next;
+        snapshot_write(&w, &off, sizeof(uint));
+        next += strlen(g->v_name[i]) + 1;
+    }
+    snapshot_pad(&w);
+    snapshot_write(&w, g->names.slots, sizeof(name_slot) * g->names.capacity);
+    snapshot_write(&w, g->adj_off, sizeof(uint) * (g->v_num + 1));
+    snapshot_pad(&w);
+    snapshot_write(&w, g->adj, sizeof(uint) * h.n_adj);
+    snapshot_pad(&w);
+    snapshot_write(&w, g->adj_w, sizeof(uint) * h.n_adj);
+    snapshot_pad(&w);
+    if (h.valid & CALCULA_COMPONENTES) {
+        snapshot_write(&w, g->component, sizeof(uint) * g->v_num);
+        snapshot_pad(&w);
+        snapshot_write(&w, g->color, g->v_num);
+        snapshot_pad(&w);
+        snapshot_write(&w, g->odd_cycle, sizeof(uint) * h.odd_len);
+        snapshot_pad(&w);
+    }
+    snapshot_write(&w, g->vertex_cut.v, sizeof(uint) * h.n_vertex_cut);
+    snapshot_pad(&w);
+    snapshot_write(&w, g->edge_cut.v, sizeof(uint) * h.n_edge_cut);
+    snapshot_pad(&w);
+    snapshot_write(&w, g->diametros.v, sizeof(uint) * h.n_diametros);
+    snapshot_pad(&w);
+    for (uint i = 0; i < g->v_num; i++)
+        snapshot_write(&w, g->v_name[i], strlen(g->v_name[i]) + 1);
+    snapshot_pad(&w);
+
+    h.checksum = snapshot_header_sum(&h, w.checksum);
+    w.ok = w.ok && !fseek(w.f, 0, SEEK_SET) && (fwrite(&h, sizeof(snapshot_header), 1, w.f) == 1);
+    w.ok = !fclose(w.f) && w.ok && !rename(tmp, caminho);
+    if (!w.ok)
+        unlink(tmp);
+    free(tmp);
+
+    return (uint)w.ok;
+}
+
+//------------------------------------------------------------------------------
+// lê um grafo gravado por salva_grafo_binario() no arquivo de nome 'caminho' e o
+// devolve, ou NULL se o arquivo não puder ser lido ou não for válido
+grafo* carrega_grafo_binario(const char* caminho)
+{
+    const snapshot_header* h;
+    struct stat st;
+    grafo* g;
+    void* map;
+    int fd;
+    STATS_START(start);
+
+    if ((fd = open(caminho, O_RDONLY)) < 0)
+        return NULL;
+
+    if ((fstat(fd, &st) < 0) || ((size_t)st.st_size < sizeof(snapshot_header))) {
+        close(fd);
+        return NULL;
+    }
+
+    // a shared read-only mapping, so every process that loads the file uses the same pages
+    map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+        return NULL;
+
+    h = map;
+    if (!snapshot_check(h, (size_t)st.st_size) || !(g = load_snapshot(map, (size_t)st.st_size))) {
+        munmap(map, (size_t)st.st_size);
+        return NULL;
+    }
+    STATS_STOP(g->stats.leitura, start);
+    STATS_PEAK(g, 0);
 
     return g;
 }
@@ -149,22 +794,35 @@ unsigned int destroi_grafo(grafo* g)
     if (g == NULL)
         return 0;
 
-    if (g->name)
-        free(g->name);
-
-    if (g->v) {
-        for (uint i = 0; i < g->v_num; i++) {
-            if (g->v[i].name)
-                free(g->v[i].name);
-            destroy_neighbor_list(g->v[i].n_list);
-        }
-        free(g->v);
+#ifdef GRAFO_STATS
+    stats_dump(g);
+#endif
+
+    free(g->v_name);
+    free(g->staged.e);
+    if (!g->shared) {
+        free(g->names.slots);
+        free(g->adj_off);
+        free(g->adj);
+        free(g->adj_w);
     }
 
-    destroy_str_list(g->vertex_cut);
-    destroy_str_list(g->edge_cut);
-    destroy_str_list(g->diametros);
-
+    destroy_uint_list(g->vertex_cut);
+    destroy_uint_list(g->edge_cut);
+    destroy_uint_list(g->diametros);
+    free_blocks(&g->blocks);
+    free(g->dsu.parent);
+    free(g->dsu.rank);
+    free(g->dsu.parity);
+    free(g->dsu.size);
+    bc_free(&g->bc);
+    free(g->component);
+    free(g->color);
+    free(g->odd_cycle);
+
+    arena_free(&g->mem);
+    if (g->snapshot != NULL)
+        munmap(g->snapshot, g->snapshot_len);
     free(g);
 
     return 1;
@@ -174,109 +832,340 @@ unsigned int destroi_grafo(grafo* g)
 // devolve o nome de g
 char* nome(grafo* g) { return g->name; }
 
+//------------------------------------------------------------------------------
+// define o número de threads usadas nos cálculos de g (0 para uma por processador)
+void define_n_threads(grafo* g, unsigned int n_threads) { g->n_threads = n_threads; }
+
+//------------------------------------------------------------------------------
+// define o algoritmo (DIAMETRO_*) usado no cálculo dos diâmetros de g
+void define_modo_diametro(grafo* g, unsigned int modo) { g->diameter_mode = modo; }
+
+//------------------------------------------------------------------------------
+// define o algoritmo (CAMINHOS_*) usado nos cálculos de caminhos mínimos de g
+void define_algoritmo_caminhos(grafo* g, unsigned int algoritmo)
+{
+    g->path_mode = algoritmo;
+    choose_kernel(g);
+}
+
+//------------------------------------------------------------------------------
+// renumera os vértices de g na ordem 'ordem' (ORDEM_*) e, se 'anterior' não é NULL,
+// preenche 'anterior' com o índice que cada vértice tinha antes
+// devolve 1 em caso de sucesso e 0 se a ordem não existe
+unsigned int reordena_vertices(grafo* g, unsigned int ordem, unsigned int* anterior)
+{
+    uint* order;
+
+    if (ordem > ORDEM_GRAU)
+        return 0;
+
+    // edges inserted since the last analysis
+    if (g->staged.size > 0 || g->adj_v_num < g->v_num)
+        build_adjacency(g);
+
+    if (!(order = malloc(sizeof(uint) * (g->v_num + 1)))) {
+        fprintf(stderr, "Erro reordena_vertices: nao foi possivel alocar ordem\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (ordem == ORDEM_GRAU)
+        degree_order(g, order);
+    else
+        bfs_order(g, order, ordem == ORDEM_RCM);
+
+    if (anterior != NULL)
+        memcpy(anterior, order, sizeof(uint) * g->v_num);
+    renumber_vertices(g, order);
+    free(order);
+
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+// devolve o número de execuções de Dijkstra feitas no cálculo dos diâmetros de g
+unsigned int execucoes_dijkstra(grafo* g) { return g->n_sssp; }
+
+//------------------------------------------------------------------------------
+// devolve o número de bytes usados pela arena de g
+size_t memoria_arena(grafo* g) { return g->mem.used; }
+
+//------------------------------------------------------------------------------
+// preenche 'stats' com os contadores de desempenho de g
+// devolve 1 se a biblioteca foi compilada com GRAFO_STATS e 0 caso contrário
+unsigned int estatisticas_grafo(grafo* g, grafo_stats* stats)
+{
+#ifdef GRAFO_STATS
+    *stats = g->stats;
+
+    return 1;
+#else
+    (void)g;
+    memset(stats, 0, sizeof(grafo_stats));
+
+    return 0;
+#endif
+}
+
+//------------------------------------------------------------------------------
+// acrescenta a g o vértice de nome 'nome', se ele ainda não existe
+// devolve o índice do vértice
+long long int adiciona_vertice(grafo* g, const char* nome)
+{
+    uint old_v_num = g->v_num;
+    uint v = intern_vert(g, nome, strlen(nome), hash_name(nome, strlen(nome)));
+
+    dsu_grow(g);
+
+    // a new vertex is a new component, with no cut vertices nor bridges
+    if (g->v_num != old_v_num) {
+        g->valid &= CALCULA_CORTES;
+        if (g->bc.up != NULL)
+            bc_grow(g);
+    }
+
+    return v;
+}
+
+//------------------------------------------------------------------------------
+// acrescenta a g a aresta {nome1, nome2} de peso 'peso', e os seus vértices se eles
+// ainda não existem; devolve 1 em caso de sucesso e 0 em caso de erro
+unsigned int adiciona_aresta(grafo* g, const char* nome1, const char* nome2, unsigned int peso)
+{
+    if ((nome1 == NULL) || (nome2 == NULL))
+        return 0;
+
+    uint a = (uint)adiciona_vertice(g, nome1);
+    uint b = (uint)adiciona_vertice(g, nome2);
+
+    // the cuts follow the edge in the block-cut forest, which needs the graph and its
+    // components as they were before it
+    if (g->valid & CALCULA_CORTES)
+        bc_insert(g, a, b);
+    stage_edge(g, a, b, peso);
+    dsu_union(&g->dsu, a, b);
+
+    // the other results are computed again from the new adjacency when asked for
+    g->valid &= CALCULA_CORTES;
+
+    return 1;
+}
+
 //------------------------------------------------------------------------------
 // devolve o número de vértices em g
 unsigned int n_vertices(grafo* g) { return g->v_num; }
 
+//------------------------------------------------------------------------------
+// devolve o índice do vértice de nome 'nome' em g ou -1 caso ele não exista
+long long int busca_vertice(grafo* g, const char* nome)
+{
+    return search_vert(g, nome, strlen(nome));
+}
+
+//------------------------------------------------------------------------------
+// devolve o nome do vértice de índice 'i' em g ou NULL caso ele não exista
+char* nome_vertice(grafo* g, unsigned int i)
+{
+    if (i >= g->v_num)
+        return NULL;
+
+    return g->v_name[i];
+}
+
 //------------------------------------------------------------------------------
 // devolve o número de arestas em g
 unsigned int n_arestas(grafo* g)
 {
-    uint arestas = 0;
-
-    for (uint i = 0; i < g->v_num; i++)
-        arestas += g->v[i].n_num;
+    if (g->staged.size > 0)
+        build_adjacency(g);
 
-    return arestas / 2;
+    return g->e_num;
 }
 
 //------------------------------------------------------------------------------
 // devolve o número de componentes em g
 unsigned int n_componentes(grafo* g)
 {
-    if (g->n_componentes != 0)
-        return g->n_componentes;
+    // once edges are inserted, the union-find keeps the count
+    if (g->dsu.parent != NULL)
+        return g->dsu.sets;
 
-    g->n_componentes = set_components(g);
+    compute(g, CALCULA_COMPONENTES);
 
     return g->n_componentes;
 }
 
-// set the state of the vertices in list 'V' of size 'size' as 'state'
-void set_states(vertice* V, uint size, int state)
-{
-    if (V == NULL)
-        return;
-
-    for (uint i = 0; i < size; i++)
-        V[i].estado = state;
-}
-
 //------------------------------------------------------------------------------
 // devolve uma "string" com os nomes dos vértices de corte de g em
 // ordem alfabética, separados por brancos
 char* vertices_corte(grafo* g)
 {
-    char* name_list = create_str_from_str_list(g->vertex_cut.str, g->vertex_cut.size, comp_name);
+    compute(g, CALCULA_CORTES);
+    if (g->bc.stale)
+        bc_cut_lists(g);
+
+    char* name_list = create_str_from_items(g, &g->vertex_cut, ITEM_VERTEX);
 
     return name_list;
 }
 
+//------------------------------------------------------------------------------
+// escreve em f os vértices de corte de g como em vertices_corte()
+// devolve 1 em caso de sucesso e 0 em caso de erro
+unsigned int escreve_vertices_corte(grafo* g, FILE* f)
+{
+    compute(g, CALCULA_CORTES);
+    if (g->bc.stale)
+        bc_cut_lists(g);
+
+    return write_items(f, g, &g->vertex_cut, ITEM_VERTEX);
+}
+
+//------------------------------------------------------------------------------
+// chama 'visita' para cada vértice de corte de g em ordem alfabética
+// devolve o número de vértices visitados
+unsigned int visita_vertices_corte(
+    grafo* g, int (*visita)(const char* item, void* dados), void* dados)
+{
+    compute(g, CALCULA_CORTES);
+    if (g->bc.stale)
+        bc_cut_lists(g);
+
+    return visit_items(g, &g->vertex_cut, ITEM_VERTEX, visita, dados);
+}
+
+//------------------------------------------------------------------------------
+// preenche 'vertices', se não é NULL, com os índices dos vértices de corte de g na
+// ordem de vertices_corte()
+// devolve o número de vértices de corte
+unsigned int vertices_corte_indices(grafo* g, unsigned int* vertices)
+{
+    compute(g, CALCULA_CORTES);
+    if (g->bc.stale)
+        bc_cut_lists(g);
+
+    return copy_items(g, &g->vertex_cut, ITEM_VERTEX, vertices);
+}
+
 //------------------------------------------------------------------------------
 // devolve uma "string" com as arestas de corte de g em ordem alfabética, separadas por brancos
 // cada aresta é o par de nomes de seus vértices em ordem alfabética, separadas por brancos
 char* arestas_corte(grafo* g)
 {
-    char* name_list = create_str_from_str_list(g->edge_cut.str, g->edge_cut.size, comp_name);
+    compute(g, CALCULA_CORTES);
+    if (g->bc.stale)
+        bc_cut_lists(g);
+
+    char* name_list = create_str_from_items(g, &g->edge_cut, ITEM_EDGE);
 
     return name_list;
 }
 
+//------------------------------------------------------------------------------
+// escreve em f as arestas de corte de g como em arestas_corte()
+// devolve 1 em caso de sucesso e 0 em caso de erro
+unsigned int escreve_arestas_corte(grafo* g, FILE* f)
+{
+    compute(g, CALCULA_CORTES);
+    if (g->bc.stale)
+        bc_cut_lists(g);
+
+    return write_items(f, g, &g->edge_cut, ITEM_EDGE);
+}
+
+//------------------------------------------------------------------------------
+// chama 'visita' para cada aresta de corte de g em ordem alfabética
+// devolve o número de arestas visitadas
+unsigned int visita_arestas_corte(
+    grafo* g, int (*visita)(const char* item, void* dados), void* dados)
+{
+    compute(g, CALCULA_CORTES);
+    if (g->bc.stale)
+        bc_cut_lists(g);
+
+    return visit_items(g, &g->edge_cut, ITEM_EDGE, visita, dados);
+}
+
+//------------------------------------------------------------------------------
+// preenche 'extremos', se não é NULL, com os pares de índices dos vértices das arestas
+// de corte de g na ordem de arestas_corte()
+// devolve o número de arestas de corte
+unsigned int arestas_corte_indices(grafo* g, unsigned int* extremos)
+{
+    compute(g, CALCULA_CORTES);
+    if (g->bc.stale)
+        bc_cut_lists(g);
+
+    return copy_items(g, &g->edge_cut, ITEM_EDGE, extremos);
+}
+
+//------------------------------------------------------------------------------
+// devolve o número de blocos de g e aponta 'inicio' e 'arestas' para suas arestas
+unsigned int blocos(grafo* g, const unsigned int** inicio, const unsigned int** arestas)
+{
+    compute(g, CALCULA_BLOCOS);
+
+    *inicio = g->blocks.edge_off;
+    *arestas = g->blocks.edges;
+
+    return g->blocks.n;
+}
+
+//------------------------------------------------------------------------------
+// devolve o número de componentes 2-aresta-conexos de g e aponta 'componente' para
+// o componente de cada vértice
+unsigned int componentes_2_arestas(grafo* g, const unsigned int** componente)
+{
+    compute(g, CALCULA_BLOCOS);
+
+    *componente = g->blocks.comp_2ecc;
+
+    return g->blocks.n_2ecc;
+}
+
+//------------------------------------------------------------------------------
+// devolve o número de blocos de g e aponta 'inicio' e 'cortes' para os vértices de
+// corte de cada bloco, as arestas da árvore de blocos e cortes
+unsigned int arvore_blocos(grafo* g, const unsigned int** inicio, const unsigned int** cortes)
+{
+    compute(g, CALCULA_BLOCOS);
+
+    *inicio = g->blocks.cut_off;
+    *cortes = g->blocks.cuts;
+
+    return g->blocks.n;
+}
+
 //------------------------------------------------------------------------------
 // devolve 1 se g é bipartido e 0 caso contrário
 unsigned int bipartido(grafo* g)
 {
-    queue_t* queue = NULL;
-    vertice* v;
-    neighbor* w;
-    vertice* r;
+    if (g->dsu.parent != NULL)
+        return !g->dsu.odd;
 
-    // for each vevrtice, set the component of the connected subgraph it belongs to
-    for (uint i = 0; i < g->v_num; i++) {
-        // initialize veritces state
-        set_states(g->v, g->v_num, 0);
-
-        r = &g->v[i];
-        r->pai = NULL;
-        r->estado = 1;
-        r->nivel = 0;
-        queue_append(&queue, r);
-
-        // pop vertice from queue until it empties
-        while ((v = queue_pop(&queue))) {
-            // iterate through neighbors
-            w = v->n_list;
-            while (w != NULL) {
-                if (g->v[w->idx].estado == 1) {
-                    if ((g->v[w->idx].nivel % 2) == (v->nivel % 2)) {
-                        destroy_queue(&queue);
-                        return 0;
-                    }
-                }
-                if (g->v[w->idx].estado == 0) {
-                    // if neighbor wasnt processed, append to queue
-                    queue_append(&queue, &(g->v[w->idx]));
-                    g->v[w->idx].pai = v;
-                    g->v[w->idx].estado = 1;
-                    g->v[w->idx].nivel = v->nivel + 1;
-                }
-                w = w->next;
-            }
-        }
+    compute(g, CALCULA_BIPARTIDO);
+
+    return g->bipartite;
+}
+
+//------------------------------------------------------------------------------
+// devolve 1 se g é bipartido e 0 caso contrário; preenche 'cor' com a classe de cada
+// vértice se g é bipartido, ou 'ciclo' e 'tam_ciclo' com um ciclo ímpar se não é
+unsigned int biparticao(
+    grafo* g, unsigned char* cor, unsigned int* ciclo, unsigned int* tam_ciclo)
+{
+    compute(g, CALCULA_BIPARTIDO);
+
+    if (g->bipartite) {
+        for (uint i = 0; (cor != NULL) && (i < g->v_num); i++)
+            cor[i] = g->color[i];
+    } else {
+        if (ciclo != NULL)
+            memcpy(ciclo, g->odd_cycle, sizeof(uint) * g->odd_len);
+        if (tam_ciclo != NULL)
+            *tam_ciclo = g->odd_len;
     }
 
-    destroy_queue(&queue);
-    return 1;
+    return g->bipartite;
 }
 
 //------------------------------------------------------------------------------
@@ -284,749 +1173,3382 @@ unsigned int bipartido(grafo* g)
 // decrescente
 char* diametros(grafo* g)
 {
+    compute(g, CALCULA_DIAMETROS);
 
-    char* name_list = create_str_from_str_list(g->diametros.str, g->diametros.size, comp_number);
+    char* name_list = create_str_from_items(g, &g->diametros, ITEM_NUMBER);
 
     return name_list;
 }
 
-// sets the number of the component of all vertices in the graph g
-// and returns number of components of the graph (uses BFS)
-uint set_components(grafo* g)
+//------------------------------------------------------------------------------
+// escreve em f os diâmetros dos componentes de g como em diametros()
+// devolve 1 em caso de sucesso e 0 em caso de erro
+unsigned int escreve_diametros(grafo* g, FILE* f)
 {
-    queue_t* queue = NULL;
-    vertice* v;
-    neighbor* w;
-    vertice* r;
-    uint c = 0;
+    compute(g, CALCULA_DIAMETROS);
 
-    // initialize component number of all vertices
-    for (uint i = 0; i < g->v_num; i++)
-        g->v[i].componente = 0;
+    return write_items(f, g, &g->diametros, ITEM_NUMBER);
+}
 
-    // for each vertice, set the component of the connected subgraph it belongs to
-    for (uint i = 0; i < g->v_num; i++) {
-        if (g->v[i].componente == 0) {
-            // initialize veritces state
-            set_states(g->v, g->v_num, 0);
-
-            r = &g->v[i];
-            r->pai = NULL;
-            r->estado = 1;
-            r->componente = ++c;
-            queue_append(&queue, r);
-
-            // pop vertex from queue until it empties
-            while ((v = queue_pop(&queue))) {
-                //  iterate through neighbors
-                w = v->n_list;
-                while (w != NULL) {
-                    if (g->v[w->idx].estado == 0) {
-                        // if neighbor wasnt processed, append to queue
-                        queue_append(&queue, &(g->v[w->idx]));
-                        g->v[w->idx].pai = v;
-                        g->v[w->idx].estado = 1;
-                        g->v[w->idx].componente = c;
-                    }
-                    w = w->next;
-                }
-            }
-        }
-    }
+//------------------------------------------------------------------------------
+// chama 'visita' para o diâmetro de cada componente de g em ordem não decrescente
+// devolve o número de diâmetros visitados
+unsigned int visita_diametros(grafo* g, int (*visita)(const char* item, void* dados), void* dados)
+{
+    compute(g, CALCULA_DIAMETROS);
+
+    return visit_items(g, &g->diametros, ITEM_NUMBER, visita, dados);
+}
+
+//------------------------------------------------------------------------------
+// preenche 'valores', se não é NULL, com os diâmetros dos componentes de g em ordem
+// não decrescente
+// devolve o número de componentes
+unsigned int diametros_valores(grafo* g, unsigned int* valores)
+{
+    compute(g, CALCULA_DIAMETROS);
+
+    return copy_items(g, &g->diametros, ITEM_NUMBER, valores);
+}
+
+//------------------------------------------------------------------------------
+// preenche 'inferior' e 'superior' com limites para o diâmetro de cada componente
+// de g, calculados com 'varreduras' execuções de Dijkstra por componente
+// devolve o número de componentes
+unsigned int diametros_aprox(
+    grafo* g, unsigned int varreduras, unsigned int* inferior, unsigned int* superior)
+{
+    compute(g, CALCULA_COMPONENTES);
+
+    sweep_diameters(g, (varreduras > 0) ? varreduras : 1, inferior, superior);
+
+    return g->n_componentes;
+}
+
+// sets in 'order' the vertices of g in BFS order, one component after the other, each
+// searched from its vertex of smallest index. With 'rcm' the order is reverse
+// Cuthill-McKee: each search starts from the vertex of smallest degree not yet reached,
+// the new neighbors of a vertex are queued by increasing degree and the order is reversed
+// at the end. 'order' is the queue of the searches
+void bfs_order(grafo* g, uint* order, uint rcm)
+{
+    unsigned long long *start = NULL, *key;
+    unsigned char* seen;
+    uint n = g->v_num;
+    uint head, tail = 0;
+    uint max_deg = 0;
+
+    for (uint v = 0; v < n; v++) {
+        if (g->adj_off[v + 1] - g->adj_off[v] > max_deg)
+            max_deg = g->adj_off[v + 1] - g->adj_off[v];
+    }
+
+    seen = calloc(n + 1, 1);
+    key = malloc(sizeof(unsigned long long) * max_deg + 1);
+    if (rcm)
+        start = malloc(sizeof(unsigned long long) * n + 1);
+    if (!seen || !key || (rcm && !start)) {
+        fprintf(stderr, "Erro bfs_order: nao foi possivel alocar busca\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // the keys are (degree << 32) | vertex, so sorting them sorts the vertices by degree,
+    // ties broken by index
+    if (rcm) {
+        for (uint v = 0; v < n; v++)
+            start[v] = ((unsigned long long)(g->adj_off[v + 1] - g->adj_off[v]) << 32) | v;
+        qsort(start, n, sizeof(unsigned long long), comp_adj_key);
+    }
+
+    for (uint i = 0; i < n; i++) {
+        uint s = rcm ? (uint)(start[i] & UINT_MAX) : i;
+
+        if (seen[s])
+            continue;
+        seen[s] = 1;
+        order[tail++] = s;
+
+        for (head = tail - 1; head < tail; head++) {
+            uint v = order[head];
+            uint first = tail;
+
+            for (uint k = g->adj_off[v]; k < g->adj_off[v + 1]; k++) {
+                if (!seen[g->adj[k]]) {
+                    seen[g->adj[k]] = 1;
+                    order[tail++] = g->adj[k];
+                }
+            }
+
+            if (!rcm || (tail - first < 2))
+                continue;
+            for (uint j = first; j < tail; j++) {
+                uint w = order[j];
+                uint deg = g->adj_off[w + 1] - g->adj_off[w];
+                key[j - first] = ((unsigned long long)deg << 32) | w;
+            }
+            qsort(key, tail - first, sizeof(unsigned long long), comp_adj_key);
+            for (uint j = first; j < tail; j++)
+                order[j] = (uint)(key[j - first] & UINT_MAX);
+        }
+    }
+
+    for (uint i = 0; rcm && (i < n / 2); i++) {
+        uint t = order[i];
+        order[i] = order[n - 1 - i];
+        order[n - 1 - i] = t;
+    }
+
+    free(seen);
+    free(key);
+    free(start);
+}
+
+// sets in 'order' the vertices of g by decreasing degree, ties broken by index, so the
+// rows of the hubs, which the searches read most, are together at the start of adj
+void degree_order(grafo* g, uint* order)
+{
+    unsigned long long* key;
+    uint n = g->v_num;
+
+    if (!(key = malloc(sizeof(unsigned long long) * n + 1))) {
+        fprintf(stderr, "Erro degree_order: nao foi possivel alocar ordem\n");
+        exit(EXIT_FAILURE);
+    }
+
+    for (uint v = 0; v < n; v++)
+        key[v] = ((unsigned long long)(UINT_MAX - (g->adj_off[v + 1] - g->adj_off[v])) << 32) | v;
+    qsort(key, n, sizeof(unsigned long long), comp_adj_key);
+
+    for (uint i = 0; i < n; i++)
+        order[i] = (uint)(key[i] & UINT_MAX);
+
+    free(key);
+}
+
+// renumbers the vertices of g so that vertex order[i] becomes vertex i, moving the names
+// and the rows of the adjacency
+// the results computed refer to the old indices, so they are dropped, as is the
+// union-find of the insertions, which the next insertion builds again from the adjacency
+void renumber_vertices(grafo* g, const uint* order)
+{
+    uint *rank, *off, *pos, *adj, *adj_w;
+    uint n = g->v_num;
+    char** names;
+
+    if (n == 0)
+        return;
+
+    detach_snapshot(g);
+
+    rank = malloc(sizeof(uint) * n);
+    off = malloc(sizeof(uint) * (n + 1));
+    pos = malloc(sizeof(uint) * (n + 1));
+    adj = malloc(sizeof(uint) * g->adj_off[n] + 1);
+    adj_w = malloc(sizeof(uint) * g->adj_off[n] + 1);
+    names = malloc(sizeof(char*) * g->max_v_num);
+    if (!rank || !off || !pos || !adj || !adj_w || !names) {
+        fprintf(stderr, "Erro renumber_vertices: nao foi possivel alocar lista de adjacencia\n");
+        exit(EXIT_FAILURE);
+    }
+
+    off[0] = 0;
+    for (uint i = 0; i < n; i++) {
+        rank[order[i]] = i;
+        off[i + 1] = off[i] + g->adj_off[order[i] + 1] - g->adj_off[order[i]];
+        names[i] = g->v_name[order[i]];
+    }
+    for (uint i = n; i < g->max_v_num; i++)
+        names[i] = NULL;
+
+    // each vertex i is appended to the rows of its neighbors in increasing order of i, so
+    // the rows come out sorted by the new indices without sorting them. The weights can
+    // be taken from the row of i, as both rows of an edge keep the same weight
+    memcpy(pos, off, sizeof(uint) * n);
+    for (uint i = 0; i < n; i++) {
+        for (uint k = g->adj_off[order[i]]; k < g->adj_off[order[i] + 1]; k++) {
+            uint w = rank[g->adj[k]];
+            adj[pos[w]] = i;
+            adj_w[pos[w]++] = g->adj_w[k];
+        }
+    }
+
+    for (uint i = 0; i < g->names.capacity; i++) {
+        if (g->names.slots[i].idx != EMPTY_SLOT)
+            g->names.slots[i].idx = rank[g->names.slots[i].idx];
+    }
+
+    free(g->adj_off);
+    free(g->adj);
+    free(g->adj_w);
+    free(g->v_name);
+    g->adj_off = off;
+    g->adj = adj;
+    g->adj_w = adj_w;
+    g->v_name = names;
+
+    g->valid = 0;
+    free_blocks(&g->blocks);
+    bc_free(&g->bc);
+    free(g->dsu.parent);
+    free(g->dsu.rank);
+    free(g->dsu.parity);
+    free(g->dsu.size);
+    memset(&g->dsu, 0, sizeof(dsu_t));
+
+    free(rank);
+    free(pos);
+}
+
+// sets the number of the component of all vertices in the graph g
+// and returns number of components of the graph (uses BFS)
+// the components are numbered from 1 in the order of their vertex of smallest index, and
+// 2-colored by the parity of the BFS level of each vertex
+uint set_components(grafo* g)
+{
+    uint *level, *queue;
+    uint c = 0;
+    bfs_t b;
+    STATS_START(start);
+
+    level = malloc(sizeof(uint) * (g->v_num + 1));
+    queue = malloc(sizeof(uint) * (g->v_num + 1));
+    if (!level || !queue) {
+        fprintf(stderr, "Erro set_components: nao foi possivel alocar fila\n");
+        exit(EXIT_FAILURE);
+    }
+    bfs_init(&b, g, level, queue);
+    STATS_INC(g->stats.filas_alocadas);
+    STATS_PEAK(g, sizeof(uint) * 3 * ((size_t)g->v_num + 1) + g->v_num + 1
+            + sizeof(unsigned long long) * 2 * b.n_words);
+
+    free(g->component);
+    free(g->color);
+    g->component = malloc(sizeof(uint) * (g->v_num + 1));
+    g->color = malloc(g->v_num + 1);
+    if (!g->component || !g->color) {
+        fprintf(stderr, "Erro set_components: nao foi possivel alocar componentes\n");
+        exit(EXIT_FAILURE);
+    }
+    g->bipartite = 1;
+    free(g->odd_cycle);
+    g->odd_cycle = NULL;
+    g->odd_len = 0;
+
+    // each search from a vertex not yet seen labels one component
+    // the levels of the ends of an edge differ by one at most, so the coloring is proper
+    // unless an edge joins two vertices of the same level, closing an odd cycle. The
+    // top-down steps look at every edge of the vertices they expand and report such an
+    // edge; the components with bottom-up steps, which skip edges, are checked again
+    for (uint i = 0; i < g->v_num; i++) {
+        uint first = b.n_queued, bottom_up = b.bottom_up;
+
+        if (level[i] != UINT_MAX)
+            continue;
+
+        c++;
+        bfs_run(g, &b, i);
+        for (uint j = first; j < b.n_queued; j++) {
+            g->component[queue[j]] = c;
+            g->color[queue[j]] = (unsigned char)(level[queue[j]] & 1);
+        }
+
+        if (!g->bipartite)
+            continue;
+        if (b.odd[0] != UINT_MAX) {
+            g->bipartite = 0;
+            set_odd_cycle(g, level, b.odd[0], b.odd[1]);
+            continue;
+        }
+        for (uint j = first; (b.bottom_up != bottom_up) && (j < b.n_queued); j++) {
+            uint v = queue[j];
+            for (uint k = g->adj_off[v]; g->bipartite && (k < g->adj_off[v + 1]); k++) {
+                if (level[g->adj[k]] == level[v]) {
+                    g->bipartite = 0;
+                    set_odd_cycle(g, level, v, g->adj[k]);
+                }
+            }
+        }
+    }
+
+    bfs_free(&b);
+    free(level);
+    free(queue);
+    STATS_STOP(g->stats.componentes, start);
+
+    return c;
+}
+
+// saves in the graph the odd cycle closed by the edge {a, b}, whose ends have the same
+// BFS level: the paths from a and from b up the BFS levels until they meet, plus the
+// edge itself. The paths hold one vertex per level, so they only share the last one
+void set_odd_cycle(grafo* g, const uint* level, uint a, uint b)
+{
+    uint x = a, y = b;
+    uint n = 0;
+
+    // the ends climb in lockstep, as they are on the same level
+    while (x != y) {
+        x = bfs_up(g, level, x);
+        y = bfs_up(g, level, y);
+        n++;
+    }
+
+    g->odd_len = 2 * n + 1;
+    if (!(g->odd_cycle = malloc(sizeof(uint) * g->odd_len))) {
+        fprintf(stderr, "Erro set_odd_cycle: nao foi possivel alocar ciclo impar\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // a, ..., common ancestor, ..., b
+    x = a;
+    y = b;
+    for (uint i = 0; i < n; i++) {
+        g->odd_cycle[i] = x;
+        g->odd_cycle[2 * n - i] = y;
+        x = bfs_up(g, level, x);
+        y = bfs_up(g, level, y);
+    }
+    g->odd_cycle[n] = x;
+}
+
+// returns the neighbor of smallest index of v one BFS level above it; v must not be a root
+uint bfs_up(grafo* g, const uint* level, uint v)
+{
+    uint k = g->adj_off[v];
+
+    while (level[g->adj[k]] + 1 != level[v])
+        k++;
+
+    return g->adj[k];
+}
+
+// sets the number of the component of all vertices in the graph g, as set_components()
+// does, but with a union-find shared by 'n_threads' threads, and returns the number of
+// components of the graph; the vertices are not colored
+//
+// a set is always hooked under the root of smaller index, so the root of each component
+// is its vertex of smallest index and every vertex points to a vertex before it
+uint label_components(grafo* g, uint n_threads)
+{
+    link_worker* workers;
+    uint* parent;
+    uint cursor = 0;
+    uint c = 0;
+    STATS_START(start);
+
+    parent = malloc(sizeof(uint) * (g->v_num + 1));
+    workers = malloc(sizeof(link_worker) * n_threads);
+    free(g->component);
+    g->component = malloc(sizeof(uint) * (g->v_num + 1));
+    if (!parent || !workers || !g->component) {
+        fprintf(stderr, "Erro label_components: nao foi possivel alocar componentes\n");
+        exit(EXIT_FAILURE);
+    }
+    STATS_PEAK(g, sizeof(uint) * 2 * ((size_t)g->v_num + 1) + sizeof(link_worker) * n_threads);
+
+    for (uint v = 0; v < g->v_num; v++)
+        parent[v] = v;
+
+    for (uint t = 0; t < n_threads; t++) {
+        workers[t].g = g;
+        workers[t].cursor = &cursor;
+        workers[t].parent = parent;
+    }
+    run_threads(link_thread, workers, sizeof(link_worker), n_threads);
+
+    // the components are numbered in the order of their roots, and the parent of a vertex
+    // comes before it, so it already has the number of its component
+    for (uint v = 0; v < g->v_num; v++)
+        g->component[v] = (parent[v] == v) ? ++c : g->component[parent[v]];
+
+    free(workers);
+    free(parent);
+    STATS_STOP(g->stats.componentes, start);
+
+    return c;
+}
+
+// thread that joins in the shared union-find of its link_worker the ends of the edges of
+// the vertices taken from the shared cursor; each edge is joined from its larger end
+void* link_thread(void* arg)
+{
+    link_worker* w = arg;
+    grafo* g = w->g;
+    uint first;
+
+    while ((first = __atomic_fetch_add(w->cursor, LINK_BATCH, __ATOMIC_RELAXED)) < g->v_num) {
+        for (uint v = first; (v < first + LINK_BATCH) && (v < g->v_num); v++) {
+            // the row is sorted, so the smaller neighbors come first
+            for (uint k = g->adj_off[v]; (k < g->adj_off[v + 1]) && (g->adj[k] < v); k++)
+                uf_link(w->parent, v, g->adj[k]);
+        }
+    }
+
+    return NULL;
+}
+
+// sets up b to search g, keeping the levels and queue in the arrays given, which must have
+// room for every vertex; the levels are set to UINT_MAX
+void bfs_init(bfs_t* b, grafo* g, uint* level, uint* queue)
+{
+    b->n = g->v_num;
+    b->n_words = (g->v_num + 63) / 64;
+    b->seen = malloc(sizeof(unsigned long long) * b->n_words + 1);
+    b->frontier = calloc(b->n_words + 1, sizeof(unsigned long long));
+    if (!b->seen || !b->frontier) {
+        fprintf(stderr, "Erro bfs_init: nao foi possivel alocar busca\n");
+        exit(EXIT_FAILURE);
+    }
+
+    b->level = level;
+    b->queue = queue;
+    for (uint i = 0; i < b->n; i++)
+        level[i] = UINT_MAX;
+    for (uint i = 0; i < b->n_words; i++)
+        b->seen[i] = 0;
+    if (b->n % 64)
+        b->seen[b->n_words - 1] = ~0ull << (b->n % 64);
+    b->n_queued = 0;
+    b->n_marked = 0;
+    b->bottom_up = 0;
+    b->odd[0] = b->odd[1] = UINT_MAX;
+    b->unseen_edges = (g->adj_off != NULL) ? g->adj_off[g->v_num] : 0;
+#ifdef GRAFO_STATS
+    b->scanned = 0;
+#endif
+}
+
+// forgets the vertices seen by the last searches of b, so the next one starts afresh
+// their levels go back to UINT_MAX, as the shortest path kernels expect
+void bfs_reset(bfs_t* b, grafo* g)
+{
+    for (uint i = 0; i < b->n_queued; i++)
+        b->level[b->queue[i]] = UINT_MAX;
+    for (uint i = 0; i < b->n_marked; i++)
+        b->seen[b->queue[i] >> 6] &= ~(1ull << (b->queue[i] & 63));
+    b->n_queued = 0;
+    b->n_marked = 0;
+    b->odd[0] = b->odd[1] = UINT_MAX;
+    b->unseen_edges = (g->adj_off != NULL) ? g->adj_off[g->v_num] : 0;
+}
+
+// frees the bitmaps of b; the arrays given to bfs_init belong to the caller
+void bfs_free(bfs_t* b)
+{
+    free(b->seen);
+    free(b->frontier);
+    b->seen = b->frontier = NULL;
+}
+
+// searches g from 'root', which no search of b has seen yet, appending the vertices it
+// reaches to b->queue; returns the level of the last one, the eccentricity of 'root'
+//
+// a step goes bottom-up when the edges out of the frontier are more than 1/BFS_ALPHA of
+// the edges of the vertices not yet seen, which a bottom-up step scans at most, and the
+// frontier has at least 1/BFS_BETA of the vertices, and returns to top-down when the
+// frontier gets below that. A small frontier stays top-down even when few edges are left
+// unseen, as at the end of a search of large diameter: a bottom-up step would pay for
+// the bitmaps and a scan of all the vertices to reach a few of them
+uint bfs_run(grafo* g, bfs_t* b, uint root)
+{
+    uint start = b->n_queued, end;
+    uint level = 0;
+    unsigned long long frontier_edges = bfs_reach(g, b, root, 0);
+
+    while (start < b->n_queued) {
+        if ((frontier_edges * BFS_ALPHA <= b->unseen_edges)
+            || ((unsigned long long)(b->n_queued - start) * BFS_BETA < b->n)) {
+            frontier_edges = bfs_top_down(g, b, &start, &level);
+            continue;
+        }
+
+        do {
+            end = b->n_queued;
+            frontier_edges = bfs_bottom_up(g, b, start, end, ++level);
+            start = end;
+            b->bottom_up++;
+        } while ((unsigned long long)(b->n_queued - start) * BFS_BETA >= b->n);
+    }
+
+    return b->level[b->queue[b->n_queued - 1]];
+}
+
+// marks v as seen at 'level' and queues it
+// returns the degree of v
+uint bfs_reach(grafo* g, bfs_t* b, uint v, uint level)
+{
+    uint deg = g->adj_off[v + 1] - g->adj_off[v];
+
+    b->level[v] = level;
+    b->queue[b->n_queued++] = v;
+    b->unseen_edges -= deg;
+
+    return deg;
+}
+
+// expands top-down the frontier b->queue[*start ..], queueing the neighbors not yet seen
+// at the next level, and goes on with the levels it queues while bfs_run would expand
+// them top-down too, so a graph of large diameter needs few calls
+// updates 'start' and 'level' to the last frontier queued; returns the number of its edges
+unsigned long long bfs_top_down(grafo* g, bfs_t* b, uint* start, uint* level)
+{
+    const uint *off = g->adj_off, *adj = g->adj;
+    uint *level_of = b->level, *queue = b->queue;
+    uint i = *start, end, tail = b->n_queued;
+    uint l = *level;
+    unsigned long long unseen_edges = b->unseen_edges;
+    unsigned long long edges;
+
+    // the fields of b are kept in locals, as the compiler cannot tell that the writes to
+    // the arrays do not change them
+    do {
+        end = tail;
+        edges = 0;
+        l++;
+        for (; i < end; i++) {
+            uint v = queue[i];
+            for (uint k = off[v]; k < off[v + 1]; k++) {
+                uint w = adj[k];
+                STATS_INC(b->scanned);
+                if (level_of[w] != UINT_MAX) {
+                    if ((level_of[w] == l - 1) && (b->odd[0] == UINT_MAX)) {
+                        b->odd[0] = v;
+                        b->odd[1] = w;
+                    }
+                    continue;
+                }
+                level_of[w] = l;
+                queue[tail++] = w;
+                edges += off[w + 1] - off[w];
+            }
+        }
+        unseen_edges -= edges;
+    } while ((end < tail)
+        && ((edges * BFS_ALPHA <= unseen_edges)
+            || ((unsigned long long)(tail - end) * BFS_BETA < b->n)));
+
+    *start = end;
+    *level = l;
+    b->n_queued = tail;
+    b->unseen_edges = unseen_edges;
+
+    return edges;
+}
+
+// queues at 'level' every vertex not yet seen with a neighbor in the frontier
+// b->queue[start .. end - 1], in order of index
+// returns the number of edges out of the new frontier
+unsigned long long bfs_bottom_up(grafo* g, bfs_t* b, uint start, uint end, uint level)
+{
+    unsigned long long edges = 0;
+
+    for (; b->n_marked < end; b->n_marked++)
+        b->seen[b->queue[b->n_marked] >> 6] |= 1ull << (b->queue[b->n_marked] & 63);
+    for (uint i = start; i < end; i++)
+        b->frontier[b->queue[i] >> 6] |= 1ull << (b->queue[i] & 63);
+
+    // the vertices queued here are not in the frontier bitmap, so they are not taken as
+    // neighbors in the frontier by the ones that follow them in the same step
+    for (uint i = 0; i < b->n_words; i++) {
+        unsigned long long unseen = ~b->seen[i];
+
+        while (unseen != 0) {
+            uint v = 64 * i + (uint)__builtin_ctzll(unseen);
+            unseen &= unseen - 1;
+
+            for (uint k = g->adj_off[v]; k < g->adj_off[v + 1]; k++) {
+                uint w = g->adj[k];
+                STATS_INC(b->scanned);
+                if (b->frontier[w >> 6] & (1ull << (w & 63))) {
+                    edges += bfs_reach(g, b, v, level);
+                    break;
+                }
+            }
+        }
+    }
+
+    for (uint i = start; i < end; i++)
+        b->frontier[b->queue[i] >> 6] = 0;
+
+    return edges;
+}
+
+// hashes the first 'len' characters of 'name' (FNV-1a)
+uint hash_name(const char* name, size_t len)
+{
+    uint h = 2166136261u;
+
+    for (size_t i = 0; i < len; i++) {
+        h ^= (unsigned char)name[i];
+        h *= 16777619u;
+    }
+
+    return h;
+}
+
+// returns the slot of the name table holding the vertex named by the first 'len'
+// characters of 'name', or the empty slot where it should be inserted
+name_slot* find_slot(grafo* g, const char* name, size_t len, uint hash)
+{
+    uint mask = g->names.capacity - 1;
+    uint i = hash & mask;
+    name_slot* slot;
+
+    STATS_INC(g->stats.buscas_nome);
+
+    while (1) {
+        slot = &g->names.slots[i];
+        if (slot->idx == EMPTY_SLOT)
+            return slot;
+        if (slot->hash == hash) {
+            const char* v_name = g->v_name[slot->idx];
+            if ((strncmp(v_name, name, len) == 0) && (v_name[len] == '\0'))
+                return slot;
+        }
+        i = (i + 1) & mask;
+    }
+}
+
+// doubles the capacity of the name table, rehashing every vertex
+void grow_name_table(grafo* g)
+{
+    name_slot* old = g->names.slots;
+    uint old_capacity = g->names.capacity;
+    uint mask;
+
+    g->names.capacity *= 2;
+    mask = g->names.capacity - 1;
+    if (!(g->names.slots = malloc(sizeof(name_slot) * g->names.capacity))) {
+        fprintf(stderr, "Erro grow_name_table: nao foi possivel realocar tabela de nomes\n");
+        exit(EXIT_FAILURE);
+    }
+
+    for (uint i = 0; i < g->names.capacity; i++)
+        g->names.slots[i].idx = EMPTY_SLOT;
+
+    for (uint i = 0; i < old_capacity; i++) {
+        if (old[i].idx == EMPTY_SLOT)
+            continue;
+        uint j = old[i].hash & mask;
+        while (g->names.slots[j].idx != EMPTY_SLOT)
+            j = (j + 1) & mask;
+        g->names.slots[j] = old[i];
+    }
+
+    free(old);
+}
+
+// searches the vertex named by the first 'len' characters of 'name' in the graph 'g'
+// returns index of vertex in the vertex list, or -1 if there is no such vertex
+long long int search_vert(grafo* g, const char* name, size_t len)
+{
+    name_slot* slot = find_slot(g, name, len, hash_name(name, len));
+
+    if (slot->idx == EMPTY_SLOT)
+        return -1;
+
+    return slot->idx;
+}
+
+// adds the vertex named by the first 'len' characters of 'name' to the graph 'g', unless
+// it is already there. The name is copied only when the vertex is new, so the graph owns a
+// single copy of each name. If theres no space left in the vertex list, reallocates it
+// returns index of the vertex in the list
+long long int add_vert(grafo* g, const char* name, size_t len)
+{
+    return intern_vert(g, name, len, hash_name(name, len));
+}
+
+// add_vert for a name whose hash is already known
+uint intern_vert(grafo* g, const char* name, size_t len, uint hash)
+{
+    name_slot* slot = find_slot(g, name, len, hash);
+    uint new_max;
+
+    // if vertice is already in the list, dont do anything
+    if (slot->idx != EMPTY_SLOT)
+        return slot->idx;
+
+    if (g->shared) {
+        detach_snapshot(g);
+        slot = find_slot(g, name, len, hash);
+    }
+
+    if (g->v_num >= g->max_v_num) {
+        new_max = g->max_v_num * 2;
+
+        if (!(g->v_name = realloc(g->v_name, sizeof(char*) * new_max))) {
+            fprintf(stderr, "Erro add_vert: nao foi possivel realocar lista de vertices\n");
+            exit(EXIT_FAILURE);
+        }
+
+        // sets every new vertice
+        for (uint i = g->max_v_num; i < new_max; i++)
+            g->v_name[i] = NULL;
+
+        g->max_v_num = new_max;
+    }
+
+    g->v_name[g->v_num] = arena_strdup(&g->mem, name, len);
+    slot->idx = g->v_num;
+    slot->hash = hash;
+    g->v_num++;
+
+    // keeps the load factor of the name table below 1/2
+    if (++g->names.used * 2 > g->names.capacity)
+        grow_name_table(g);
+
+    return g->v_num - 1;
+}
+
+// appends the edge between the vertices of index 'a' and 'b' with given weight to the
+// list of edges waiting to be added to the adjacency arrays
+void stage_edge(grafo* g, uint a, uint b, uint weight)
+{
+    edge_list* list = &g->staged;
+    uint new_max;
+
+    if (list->size >= list->max) {
+        if (list->max == 0) {
+            list->e = NULL;
+            new_max = STARTING_EDGE_NUM;
+        } else
+            new_max = list->max * 2;
+
+        if (!(list->e = realloc(list->e, sizeof(edge) * new_max))) {
+            fprintf(stderr, "Erro stage_edge: nao foi possivel realocar lista de arestas\n");
+            exit(EXIT_FAILURE);
+        }
+
+        list->max = new_max;
+    }
+
+    list->e[list->size].a = a;
+    list->e[list->size].b = b;
+    list->e[list->size].weight = weight;
+    list->size++;
+}
+
+// auxiliary function to compare adjacency sort keys
+int comp_adj_key(const void* a, const void* b)
+{
+    unsigned long long k1 = *(const unsigned long long*)a;
+    unsigned long long k2 = *(const unsigned long long*)b;
+    if (k1 < k2)
+        return -1;
+    else if (k1 == k2)
+        return 0;
+    return 1;
+}
+
+// moves the staged edges of 'g' to the compressed adjacency arrays.
+// Each row is sorted by neighbor index and repeated edges are dropped, keeping the
+// weight of the first one read. A loop is kept as a single entry in its vertex row
+void build_adjacency(grafo* g)
+{
+    uint *off, *adj, *adj_w, *pos, *row_w;
+    unsigned long long* key;
+    uint n = g->v_num;
+    uint total = 0;
+    uint max_deg = 0;
+
+    detach_snapshot(g);
+
+    if (!(off = calloc(n + 1, sizeof(uint))) || !(pos = malloc(sizeof(uint) * (n + 1)))) {
+        fprintf(stderr, "Erro build_adjacency: nao foi possivel alocar lista de adjacencia\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // keeps the edges already in the adjacency arrays
+    for (uint v = 0; (g->adj_off != NULL) && (v < g->adj_v_num); v++)
+        off[v + 1] = g->adj_off[v + 1] - g->adj_off[v];
+
+    // counts entries of each row
+    for (uint i = 0; i < g->staged.size; i++) {
+        off[g->staged.e[i].a + 1]++;
+        if (g->staged.e[i].a != g->staged.e[i].b)
+            off[g->staged.e[i].b + 1]++;
+    }
+
+    for (uint v = 0; v < n; v++) {
+        if (off[v + 1] > max_deg)
+            max_deg = off[v + 1];
+        off[v + 1] += off[v];
+    }
+    total = off[n];
+
+    if (!(adj = malloc(sizeof(uint) * total + 1)) || !(adj_w = malloc(sizeof(uint) * total + 1))
+        || !(key = malloc(sizeof(unsigned long long) * max_deg + 1))
+        || !(row_w = malloc(sizeof(uint) * max_deg + 1))) {
+        fprintf(stderr, "Erro build_adjacency: nao foi possivel alocar lista de adjacencia\n");
+        exit(EXIT_FAILURE);
+    }
+    STATS_PEAK(g, sizeof(uint) * (2 * ((size_t)n + 1) + 2 * (size_t)total + max_deg)
+            + sizeof(unsigned long long) * max_deg);
+
+    // fills each row in reading order
+    memcpy(pos, off, sizeof(uint) * (n + 1));
+    for (uint v = 0; (g->adj_off != NULL) && (v < g->adj_v_num); v++) {
+        for (uint k = g->adj_off[v]; k < g->adj_off[v + 1]; k++) {
+            adj[pos[v]] = g->adj[k];
+            adj_w[pos[v]++] = g->adj_w[k];
+        }
+    }
+    for (uint i = 0; i < g->staged.size; i++) {
+        edge* e = &g->staged.e[i];
+        adj[pos[e->a]] = e->b;
+        adj_w[pos[e->a]++] = e->weight;
+        if (e->a != e->b) {
+            adj[pos[e->b]] = e->a;
+            adj_w[pos[e->b]++] = e->weight;
+        }
+    }
+
+    // sorts each row by neighbor, ties broken by reading order, and removes repetitions
+    uint k = 0;
+    g->e_num = 0;
+    for (uint v = 0; v < n; v++) {
+        uint start = off[v];
+        uint deg = off[v + 1] - off[v];
+
+        for (uint i = 0; i < deg; i++) {
+            key[i] = ((unsigned long long)adj[start + i] << 32) | i;
+            row_w[i] = adj_w[start + i];
+        }
+        qsort(key, deg, sizeof(unsigned long long), comp_adj_key);
+
+        // rows are compacted in place, as a row never starts after its old position
+        off[v] = k;
+        for (uint i = 0; i < deg; i++) {
+            uint w = (uint)(key[i] >> 32);
+            if ((i > 0) && (w == (uint)(key[i - 1] >> 32)))
+                continue;
+            adj_w[k] = row_w[key[i] & UINT_MAX];
+            adj[k++] = w;
+            if (w >= v)
+                g->e_num++;
+        }
+    }
+    off[n] = k;
+
+    free(pos);
+    free(row_w);
+    free(key);
+    free(g->adj_off);
+    free(g->adj);
+    free(g->adj_w);
+    free(g->staged.e);
+
+    g->adj_off = off;
+    g->adj = adj;
+    g->adj_w = adj_w;
+    g->adj_v_num = n;
+    g->staged.e = NULL;
+    g->staged.size = g->staged.max = 0;
+
+    choose_kernel(g);
+}
+
+// picks the shortest path kernel for the weights of g
+void choose_kernel(grafo* g)
+{
+    uint min_w = UINT_MAX;
+    uint max_w = 0;
+
+    for (uint k = 0; (g->adj_off != NULL) && (k < g->adj_off[g->v_num]); k++) {
+        if (g->adj_w[k] < min_w)
+            min_w = g->adj_w[k];
+        if (g->adj_w[k] > max_w)
+            max_w = g->adj_w[k];
+    }
+
+    set_kernel(g, min_w, max_w);
+}
+
+// picks the shortest path kernel of g for edge weights between min_w and max_w: BFS when
+// every weight is 1, Dial's bucket queue when they are at most DIAL_MAX_WEIGHT and the
+// radix heap otherwise, unless the indexed heap was asked for with CAMINHOS_HEAP
+void set_kernel(grafo* g, uint min_w, uint max_w)
+{
+    if (g->path_mode == CAMINHOS_HEAP) {
+        g->max_dist = dijkstra_max_dist;
+        g->n_buckets = 0;
+    } else if ((max_w <= 1) && (min_w >= 1)) {
+        g->max_dist = bfs_max_dist;
+        g->n_buckets = 0;
+    } else if (max_w <= DIAL_MAX_WEIGHT) {
+        // a power of two above the largest weight, so buckets are picked with a mask
+        g->max_dist = dial_max_dist;
+        g->n_buckets = 1;
+        while (g->n_buckets <= max_w)
+            g->n_buckets *= 2;
+    } else {
+        g->max_dist = radix_max_dist;
+        g->n_buckets = RADIX_BUCKETS;
+    }
+}
+
+// destroys uint_list
+void destroy_uint_list(uint_list list) { free(list.v); }
+
+// creates a graph named by the first 'len' characters of 'name'
+grafo* create_graph(const char* name, size_t len)
+{
+    grafo* g;
+
+    if (!(g = malloc(sizeof(grafo))))
+        return NULL;
+
+    g->mem.head = NULL;
+    g->mem.used = 0;
+    g->name = arena_strdup(&g->mem, name, len);
+
+    if (!(g->v_name = malloc(sizeof(char*) * STARTING_VERT_NUM))) {
+        arena_free(&g->mem);
+        free(g);
+        return NULL;
+    }
+
+    if (!(g->names.slots = malloc(sizeof(name_slot) * STARTING_NAME_TABLE_SIZE))) {
+        arena_free(&g->mem);
+        free(g->v_name);
+        free(g);
+        return NULL;
+    }
+
+    g->names.capacity = STARTING_NAME_TABLE_SIZE;
+    g->names.used = 0;
+    for (uint i = 0; i < STARTING_NAME_TABLE_SIZE; i++)
+        g->names.slots[i].idx = EMPTY_SLOT;
+
+    g->v_num = 0;
+    g->max_v_num = STARTING_VERT_NUM;
+    g->n_threads = 0;
+    g->path_mode = CAMINHOS_AUTOMATICO;
+    g->n_buckets = 0;
+    g->max_dist = bfs_max_dist;
+    g->diameter_mode = DIAMETRO_LIMITES;
+    g->n_sssp = 0;
+    g->valid = 0;
+    g->n_componentes = 0;
+    g->component = NULL;
+    g->bipartite = 0;
+    g->color = NULL;
+    g->odd_cycle = NULL;
+    g->odd_len = 0;
+
+    g->vertex_cut.v = NULL;
+    g->edge_cut.v = NULL;
+    g->diametros.v = NULL;
+    g->vertex_cut.size = g->vertex_cut.max = g->vertex_cut.sorted = 0;
+    g->edge_cut.size = g->edge_cut.max = g->edge_cut.sorted = 0;
+    g->diametros.size = g->diametros.max = g->diametros.sorted = 0;
+    memset(&g->blocks, 0, sizeof(blocks_t));
+    memset(&g->dsu, 0, sizeof(dsu_t));
+    memset(&g->bc, 0, sizeof(bc_forest));
+    g->snapshot = NULL;
+    g->snapshot_len = 0;
+    g->shared = 0;
+#ifdef GRAFO_STATS
+    memset(&g->stats, 0, sizeof(grafo_stats));
+#endif
+
+    g->staged.e = NULL;
+    g->staged.size = g->staged.max = 0;
+    g->adj_off = NULL;
+    g->adj = NULL;
+    g->adj_w = NULL;
+    g->adj_v_num = 0;
+    g->e_num = 0;
+
+    for (uint i = 0; i < STARTING_VERT_NUM; i++)
+        g->v_name[i] = NULL;
+
+    return g;
+}
+
+// characters skipped by sscanf as white space
+static const unsigned char space_char[256] = {
+    [' '] = 1, ['\t'] = 1, ['\n'] = 1, ['\v'] = 1, ['\f'] = 1, ['\r'] = 1 };
+
+// parses the line that goes from 'line' up to 'end' (exclusive) as sscanf would with the
+// format "%s -- %s %d", setting 'x', 'y' and 'p' with the names of vertices and weight
+// presented in the line. The tokens point inside the line, nothing is copied
+// returns the number of fields read, or 0 if the line is blank
+int parse_line(const char* line, const char* end, token* x, token* y, uint* p)
+{
+    const char* s = line;
+    uint digit, value = 0;
+    int neg = 0;
+
+    *p = 1; // initialize with default value
+
+    while ((s < end) && space_char[(unsigned char)*s])
+        s++;
+    if (s == end)
+        return 0;
+
+    x->str = s;
+    while ((s < end) && !space_char[(unsigned char)*s])
+        s++;
+    x->len = (size_t)(s - x->str);
+
+    // " -- "
+    while ((s < end) && space_char[(unsigned char)*s])
+        s++;
+    if ((end - s < 2) || (s[0] != '-') || (s[1] != '-'))
+        return 1;
+    s += 2;
+    while ((s < end) && space_char[(unsigned char)*s])
+        s++;
+    if (s == end)
+        return 1;
+
+    y->str = s;
+    while ((s < end) && !space_char[(unsigned char)*s])
+        s++;
+    y->len = (size_t)(s - y->str);
+
+    // optional weight
+    while ((s < end) && space_char[(unsigned char)*s])
+        s++;
+    if ((s < end) && ((*s == '-') || (*s == '+')))
+        neg = (*s++ == '-');
+    if ((s == end) || ((uint)(unsigned char)*s - '0' > 9))
+        return 2;
+
+    while ((s < end) && ((digit = (uint)(unsigned char)*s - '0') <= 9)) {
+        value = value * 10 + digit;
+        s++;
+    }
+    *p = neg ? 0u - value : value;
+
+    return 3;
+}
+
+// parses the line that goes from 'line' up to 'end' (exclusive) and adds the vertex or
+// edge it describes to the graph 'g'
+// returns 0 if the line could not be parsed
+int add_line(grafo* g, const char* line, const char* end)
+{
+    token x, y;
+    uint p;
+    int res = parse_line(line, end, &x, &y, &p);
+
+    STATS_INC(g->stats.linhas);
+
+    if (res == 0)
+        return 0;
+    else if (res > 1)
+        add_graph_edge(g, x, y, p);
+    else
+        add_vert(g, x.str, x.len);
+
+    return 1;
+}
+
+// computes the results of the graph 'g' given by the CALCULA_* flags in 'what', unless they
+// were already computed. Each result is computed at most once
+void compute(grafo* g, uint what)
+{
+    uint n_threads, n_adj;
+
+    // diameters are computed per component, and so is the coloring
+    if (what & (CALCULA_DIAMETROS | CALCULA_BIPARTIDO))
+        what |= CALCULA_COMPONENTES;
+
+    what &= ~g->valid;
+
+    // edges inserted since the last analysis
+    if (what && (g->staged.size > 0 || g->adj_v_num < g->v_num))
+        build_adjacency(g);
+
+    // the search that 2-colors the graph also labels its components; when only the
+    // components are asked for and define_n_threads() asked for more than one thread,
+    // the threads label them with a union-find. The default of one thread per processor
+    // keeps the search, which also leaves the coloring ready for bipartido()
+    if (what & CALCULA_COMPONENTES) {
+        n_adj = (g->adj_off != NULL) ? g->adj_off[g->v_num] : 0;
+        n_threads = (g->n_threads > 1) ? g->n_threads : 1;
+        if (n_threads > n_adj / MIN_THREAD_ADJ + 1)
+            n_threads = n_adj / MIN_THREAD_ADJ + 1;
+
+        if (!(what & CALCULA_BIPARTIDO) && (n_threads > 1))
+            g->n_componentes = label_components(g, n_threads);
+        else
+            what |= CALCULA_BIPARTIDO;
+    }
+    if (what & CALCULA_BIPARTIDO) {
+        g->n_componentes = set_components(g);
+        what |= CALCULA_COMPONENTES;
+    }
+    if (what & (CALCULA_CORTES | CALCULA_BLOCOS)) {
+        set_cut(g);
+        what |= CALCULA_CORTES | CALCULA_BLOCOS;
+    }
+    if (what & CALCULA_DIAMETROS)
+        set_diameters(g);
+
+    g->valid |= what;
+}
+
+// reads the graph in the memory from 'data' up to 'end' (exclusive), which holds the
+// contents of an input file. The lines after the name of the graph are split in
+// 'n_threads' pieces, each parsed by a thread, and then merged in order, so that the
+// vertices get the same indices as when the lines are read one by one
+grafo* read_mapped(const char* data, const char* end, uint n_threads)
+{
+    const char *line, *next;
+    chunk_parse* chunks;
+    grafo* g = NULL;
+    uint total, ok = 1;
+
+    // the first valid line is the name of the graph
+    for (line = data; line < end; line = next) {
+        // each line keeps its '\n', as the lines read by fgets
+        next = memchr(line, '\n', (size_t)(end - line));
+        next = next ? next + 1 : end;
+
+        // skips comments and empty lines
+        if ((line[0] != '/') && (line[0] != '\n')) {
+            g = create_graph(line, (size_t)(next - line) - (next[-1] == '\n'));
+            break;
+        }
+    }
+    if (!g)
+        return NULL;
+
+    if ((size_t)(end - next) / MIN_CHUNK_BYTES < n_threads)
+        n_threads = (uint)((size_t)(end - next) / MIN_CHUNK_BYTES);
+
+    if (n_threads <= 1) {
+        for (line = next; line < end; line = next) {
+            next = memchr(line, '\n', (size_t)(end - line));
+            next = next ? next + 1 : end;
+
+            if ((line[0] == '/') || (line[0] == '\n'))
+                continue;
+
+            if (!add_line(g, line, next)) {
+                destroi_grafo(g);
+                return NULL;
+            }
+        }
+        return g;
+    }
+
+    if (!(chunks = calloc(n_threads, sizeof(chunk_parse)))) {
+        fprintf(stderr, "Erro read_mapped: nao foi possivel alocar partes da entrada\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // splits the input in pieces of about the same size, each starting at a line
+    chunks[0].start = next;
+    for (uint t = 1; t < n_threads; t++) {
+        const char* start = next + (size_t)(end - next) / n_threads * t;
+        if (start < chunks[t - 1].start)
+            start = chunks[t - 1].start;
+        if (start[-1] != '\n') {
+            const char* nl = memchr(start, '\n', (size_t)(end - start));
+            start = nl ? nl + 1 : end;
+        }
+        chunks[t].start = chunks[t - 1].end = start;
+    }
+    chunks[n_threads - 1].end = end;
+
+    run_threads(parse_chunk, chunks, sizeof(chunk_parse), n_threads);
+
+    for (uint t = 0; t < n_threads; t++) {
+        ok = ok && chunks[t].ok;
+        STATS_ADD(g->stats.linhas, chunks[t].n_lines);
+        STATS_ADD(g->stats.buscas_nome, chunks[t].n_lookups);
+    }
+    STATS_PEAK(g, stats_chunks(chunks, n_threads));
+
+    if (ok) {
+        // gives global indices to the names of each piece, in order
+        total = g->staged.size;
+        for (uint t = 0; t < n_threads; t++) {
+            chunk_parse* c = &chunks[t];
+            if (!(c->map = malloc(sizeof(uint) * c->n_names + 1))) {
+                fprintf(stderr, "Erro read_mapped: nao foi possivel alocar mapa de nomes\n");
+                exit(EXIT_FAILURE);
+            }
+            for (uint i = 0; i < c->n_names; i++)
+                c->map[i] = intern_vert(g, c->names[i].str, c->names[i].len, c->hashes[i]);
+            total += c->n_edges;
+        }
+
+        // reserves room for the edges and lets each thread translate its own
+        if (total > g->staged.max) {
+            if (!(g->staged.e = realloc(g->staged.e, sizeof(edge) * total))) {
+                fprintf(stderr, "Erro read_mapped: nao foi possivel realocar lista de arestas\n");
+                exit(EXIT_FAILURE);
+            }
+            g->staged.max = total;
+        }
+        for (uint t = 0; t < n_threads; t++) {
+            chunks[t].out = g->staged.e + g->staged.size;
+            g->staged.size += chunks[t].n_edges;
+        }
+
+        run_threads(translate_chunk, chunks, sizeof(chunk_parse), n_threads);
+    }
+
+    for (uint t = 0; t < n_threads; t++) {
+        free(chunks[t].names);
+        free(chunks[t].hashes);
+        free(chunks[t].slots);
+        free(chunks[t].edges);
+        free(chunks[t].map);
+    }
+    free(chunks);
+
+    if (!ok) {
+        destroi_grafo(g);
+        return NULL;
+    }
+
+    return g;
+}
+
+// runs 'func' on 'n' threads, the i-th one receiving the i-th element of the array 'args',
+// whose elements have 'arg_size' bytes. Returns when all of them finish
+void run_threads(void* (*func)(void*), void* args, size_t arg_size, uint n)
+{
+    pthread_t* threads;
+
+    if (!(threads = malloc(sizeof(pthread_t) * n))) {
+        fprintf(stderr, "Erro run_threads: nao foi possivel alocar threads\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // the first element is handled by the calling thread
+    for (uint t = 1; t < n; t++) {
+        if (pthread_create(&threads[t], NULL, func, (char*)args + arg_size * t) != 0) {
+            fprintf(stderr, "Erro run_threads: nao foi possivel criar thread\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    func(args);
+
+    for (uint t = 1; t < n; t++)
+        pthread_join(threads[t], NULL);
+
+    free(threads);
+}
+
+// returns the number of threads to use when asked for 'n_threads' (0 for one per processor)
+uint thread_count(uint n_threads)
+{
+    long n_cpus;
+
+    if (n_threads != 0)
+        return n_threads;
+
+    n_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return (n_cpus > 0) ? (uint)n_cpus : 1;
+}
+
+// returns the local id of the name 't' in the piece 'c', adding it if needed
+uint chunk_intern(chunk_parse* c, token t)
+{
+    uint hash = hash_name(t.str, t.len);
+    uint mask = c->capacity - 1;
+    uint i = hash & mask;
+
+    STATS_INC(c->n_lookups);
+
+    while (c->slots[i].idx != EMPTY_SLOT) {
+        token* name = &c->names[c->slots[i].idx];
+        if ((c->slots[i].hash == hash) && (name->len == t.len)
+            && (memcmp(name->str, t.str, t.len) == 0))
+            return c->slots[i].idx;
+        i = (i + 1) & mask;
+    }
+
+    if (c->n_names >= c->max_names) {
+        c->max_names *= 2;
+        if (!(c->names = realloc(c->names, sizeof(token) * c->max_names))
+            || !(c->hashes = realloc(c->hashes, sizeof(uint) * c->max_names))) {
+            fprintf(stderr, "Erro chunk_intern: nao foi possivel realocar nomes\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    c->names[c->n_names] = t;
+    c->hashes[c->n_names] = hash;
+    c->slots[i].idx = c->n_names;
+    c->slots[i].hash = hash;
+    c->n_names++;
+
+    // keeps the load factor below 1/2
+    if (c->n_names * 2 > c->capacity) {
+        name_slot* old = c->slots;
+        uint old_capacity = c->capacity;
+
+        c->capacity *= 2;
+        mask = c->capacity - 1;
+        if (!(c->slots = malloc(sizeof(name_slot) * c->capacity))) {
+            fprintf(stderr, "Erro chunk_intern: nao foi possivel realocar tabela de nomes\n");
+            exit(EXIT_FAILURE);
+        }
+        for (uint j = 0; j < c->capacity; j++)
+            c->slots[j].idx = EMPTY_SLOT;
+        for (uint j = 0; j < old_capacity; j++) {
+            if (old[j].idx == EMPTY_SLOT)
+                continue;
+            uint k = old[j].hash & mask;
+            while (c->slots[k].idx != EMPTY_SLOT)
+                k = (k + 1) & mask;
+            c->slots[k] = old[j];
+        }
+        free(old);
+    }
+
+    return c->n_names - 1;
+}
+
+// thread that parses the lines of a piece of the input (a chunk_parse)
+void* parse_chunk(void* arg)
+{
+    chunk_parse* c = arg;
+    const char *line, *next;
+    token x, y;
+    uint p;
+    int res;
+
+    c->ok = 1;
+    c->max_names = STARTING_VERT_NUM;
+    c->capacity = STARTING_NAME_TABLE_SIZE;
+    c->max_edges = STARTING_EDGE_NUM;
+    if (!(c->names = malloc(sizeof(token) * c->max_names))
+        || !(c->hashes = malloc(sizeof(uint) * c->max_names))
+        || !(c->slots = malloc(sizeof(name_slot) * c->capacity))
+        || !(c->edges = malloc(sizeof(edge) * c->max_edges))) {
+        fprintf(stderr, "Erro parse_chunk: nao foi possivel alocar parte da entrada\n");
+        exit(EXIT_FAILURE);
+    }
+    for (uint i = 0; i < c->capacity; i++)
+        c->slots[i].idx = EMPTY_SLOT;
+
+    for (line = c->start; line < c->end; line = next) {
+        next = memchr(line, '\n', (size_t)(c->end - line));
+        next = next ? next + 1 : c->end;
+
+        if ((line[0] == '/') || (line[0] == '\n'))
+            continue;
+
+        res = parse_line(line, next, &x, &y, &p);
+        STATS_INC(c->n_lines);
+        if (res == 0) {
+            c->ok = 0;
+            break;
+        }
+
+        uint a = chunk_intern(c, x);
+        if (res == 1)
+            continue;
+        uint b = chunk_intern(c, y);
+
+        if (c->n_edges >= c->max_edges) {
+            c->max_edges *= 2;
+            if (!(c->edges = realloc(c->edges, sizeof(edge) * c->max_edges))) {
+                fprintf(stderr, "Erro parse_chunk: nao foi possivel realocar arestas\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+        c->edges[c->n_edges].a = a;
+        c->edges[c->n_edges].b = b;
+        c->edges[c->n_edges].weight = p;
+        c->n_edges++;
+    }
+
+    return NULL;
+}
+
+// thread that writes the edges of a piece of the input to the graph, with the local ids
+// replaced by the indices of the vertices
+void* translate_chunk(void* arg)
+{
+    chunk_parse* c = arg;
+
+    for (uint i = 0; i < c->n_edges; i++) {
+        c->out[i].a = c->map[c->edges[i].a];
+        c->out[i].b = c->map[c->edges[i].b];
+        c->out[i].weight = c->edges[i].weight;
+    }
+
+    return NULL;
+}
+
+// reads file 'f' until a valid line is read (or EOF is found)
+// recieves a buffer 'line' with size 'size' and sets the buffer with the valid lilne.
+// If no valid line could be found, returns 0
+int get_valid_string(char* line, int size, FILE* f)
+{
+    while (1) {
+        // Read an entire line from input
+        if (!fgets(line, size, f))
+            return 0; // EOF or error
+        else if ((line[0] == '/')
+            || (line[0] == '\n')) // If the line stars with / or is empty, skip it
+            continue;
+        return 1;
+    }
+}
+
+// adds the vertices named by the tokens 'a' and 'b' to the graph 'g'
+// sets b as neighbor of a with weight 'weight', and vice-versa
+void add_graph_edge(grafo* g, token a, token b, uint weight)
+{
+    uint idx_a = (uint)add_vert(g, a.str, a.len);
+    uint idx_b = (uint)add_vert(g, b.str, b.len);
+
+    stage_edge(g, idx_a, idx_b, weight);
+}
+
+// adds x to the end of 'list'
+// reallocates list if necessary
+void add_uint(uint_list* list, uint x)
+{
+    uint new_max;
+    if (list->size >= list->max) {
+        if (list->max == 0) {
+            list->v = NULL;
+            list->max = STARTING_CUT_LIST_NUM;
+            new_max = list->max;
+        } else
+            new_max = list->max * 2;
+
+        if (!(list->v = realloc(list->v, sizeof(uint) * new_max))) {
+            fprintf(stderr, "Erro add_uint: nao foi possivel realocar lista de resultados\n");
+            exit(EXIT_FAILURE);
+        }
+
+        list->max = new_max;
+    }
+    list->v[list->size++] = x;
+    list->sorted = 0;
+}
+
+// DFS from 'root' that sets the lowpoint of every vertex in its component and adds the
+// cut vertices and bridges found to the graph's lists (Tarjan)
+// the DFS stack is an array of 's', so the depth of the search does not use the call
+// stack. The same pass splits the edges into blocks and the vertices into 2-edge-connected
+// components, closing a block when a vertex returns to a parent it cannot go above and a
+// 2-edge-connected component when it returns through a bridge
+void low_point(grafo* g, uint root, cut_search* s)
+{
+    uint top = 0;
+    uint n_filhos = 0;
+    uint r, w, p;
+
+    s->low[root] = s->level[root] = 0;
+    s->parent[root] = NO_PARENT;
+    s->state[root] = 1;
+    s->next[root] = g->adj_off[root];
+    s->stack[top++] = root;
+    s->vert_stack[s->n_verts++] = root;
+
+    while (top > 0) {
+        r = s->stack[top - 1];
+
+        // visits the next neighbor of the vertex on top of the stack
+        if (s->next[r] < g->adj_off[r + 1]) {
+            w = g->adj[s->next[r]++];
+            if ((s->state[w] == 1) && (w != r) && (w != s->parent[r])) {
+                // back edge to an ancestor
+                s->edge_stack[2 * s->n_edges] = r;
+                s->edge_stack[2 * s->n_edges++ + 1] = w;
+                if (s->level[w] < s->low[r])
+                    s->low[r] = s->level[w];
+            } else if (s->state[w] == 0) {
+                s->parent[w] = r;
+                s->low[w] = s->level[w] = s->level[r] + 1;
+                s->state[w] = 1;
+                s->next[w] = g->adj_off[w];
+                s->stack[top++] = w;
+                s->vert_stack[s->n_verts++] = w;
+                s->edge_stack[2 * s->n_edges] = r;
+                s->edge_stack[2 * s->n_edges++ + 1] = w;
+            }
+            continue;
+        }
+
+        // every neighbor of r was visited, so it returns to its parent
+        s->state[r] = 2;
+        top--;
+        if ((p = s->parent[r]) == NO_PARENT)
+            break;
+
+        if ((s->level[p] <= s->low[r]) && (s->parent[p] != NO_PARENT) && !s->is_cut[p]) {
+            // adds vertex to vertex cut
+            add_uint(&g->vertex_cut, p);
+            s->is_cut[p] = 1;
+        }
+
+        // r cannot reach above p, so the edges from {p, r} on form a block
+        if (s->level[p] <= s->low[r])
+            close_block(g, p, r, s);
+
+        if (s->level[p] < s->low[r]) {
+            // adds edge to edge cut
+            add_uint(&g->edge_cut, p);
+            add_uint(&g->edge_cut, r);
+            close_2ecc(g, r, s);
+        }
+
+        // updates lowpoint if son reaches higher
+        if (s->low[r] < s->low[p])
+            s->low[p] = s->low[r];
+
+        if (s->parent[p] == NO_PARENT)
+            n_filhos++;
+    }
+
+    if (n_filhos > 1) {
+        // adds vertex to vertex cut
+        add_uint(&g->vertex_cut, root);
+        s->is_cut[root] = 1;
+    }
+
+    close_2ecc(g, root, s);
+}
+
+// pops the edges of the edge stack down to the tree edge {top, v} as a new block
+// the popped edges are already in place at the end of the block edge array
+void close_block(grafo* g, uint top, uint v, cut_search* s)
+{
+    blocks_t* b = &g->blocks;
+    uint end = s->n_edges;
+
+    do
+        s->n_edges--;
+    while ((s->edge_stack[2 * s->n_edges] != top) || (s->edge_stack[2 * s->n_edges + 1] != v));
+
+    // the edges of the block are copied in the order they were found
+    uint first = b->edge_off[b->n];
+    memcpy(b->edges + 2 * first, s->edge_stack + 2 * s->n_edges,
+        sizeof(uint) * 2 * (end - s->n_edges));
+    b->top[b->n] = top;
+    b->edge_off[++b->n] = first + end - s->n_edges;
+}
+
+// pops the vertices of the vertex stack down to v as a new 2-edge-connected component
+void close_2ecc(grafo* g, uint v, cut_search* s)
+{
+    uint w;
+
+    do {
+        w = s->vert_stack[--s->n_verts];
+        g->blocks.comp_2ecc[w] = g->blocks.n_2ecc;
+    } while (w != v);
+
+    g->blocks.n_2ecc++;
+}
+
+// sets the cut vertices of every block, the blocks adjacent to each cut vertex in the
+// block-cut tree
+void set_block_cuts(grafo* g, const unsigned char* is_cut)
+{
+    blocks_t* b = &g->blocks;
+    uint *last, n = 0;
+
+    // each cut vertex is listed once per block, using the last block it was seen in
+    b->cut_off = malloc(sizeof(uint) * (b->n + 1));
+    b->cuts = malloc(sizeof(uint) * (2 * b->edge_off[b->n] + 1));
+    last = malloc(sizeof(uint) * (g->v_num + 1));
+    if (!b->cut_off || !b->cuts || !last) {
+        fprintf(stderr, "Erro set_block_cuts: nao foi possivel alocar arvore de blocos\n");
+        exit(EXIT_FAILURE);
+    }
+
+    for (uint v = 0; v < g->v_num; v++)
+        last[v] = UINT_MAX;
+
+    for (uint k = 0; k < b->n; k++) {
+        b->cut_off[k] = n;
+        for (uint i = 2 * b->edge_off[k]; i < 2 * b->edge_off[k + 1]; i++) {
+            uint v = b->edges[i];
+            if (is_cut[v] && (last[v] != k)) {
+                last[v] = k;
+                b->cuts[n++] = v;
+            }
+        }
+    }
+    b->cut_off[b->n] = n;
+
+    free(last);
+}
+
+// frees the arrays of the biconnected structure
+void free_blocks(blocks_t* b)
+{
+    free(b->edge_off);
+    free(b->edges);
+    free(b->top);
+    free(b->cut_off);
+    free(b->cuts);
+    free(b->comp_2ecc);
+    memset(b, 0, sizeof(blocks_t));
+}
+
+// sets the lists of cut vertices and bridges of g, and its biconnected structure
+void set_cut(grafo* g)
+{
+    uint n_edges = (g->adj_off != NULL) ? g->adj_off[g->v_num] : 0;
+    blocks_t* b = &g->blocks;
+    cut_search s;
+    STATS_START(start);
+
+    // empties vertex_cut and edge_cut lists
+    g->vertex_cut.size = 0;
+    g->edge_cut.size = 0;
+    free_blocks(b);
+    bc_free(&g->bc);
+
+    // each edge enters the edge stack and one block at most once
+    s.stack = malloc(sizeof(uint) * (g->v_num + 1));
+    s.next = malloc(sizeof(uint) * (g->v_num + 1));
+    s.parent = malloc(sizeof(uint) * (g->v_num + 1));
+    s.level = malloc(sizeof(uint) * (g->v_num + 1));
+    s.low = malloc(sizeof(uint) * (g->v_num + 1));
+    s.state = calloc(g->v_num + 1, sizeof(unsigned char));
+    s.is_cut = calloc(g->v_num + 1, sizeof(unsigned char));
+    s.edge_stack = malloc(sizeof(uint) * (n_edges + 1));
+    s.vert_stack = malloc(sizeof(uint) * (g->v_num + 1));
+    b->edge_off = malloc(sizeof(uint) * (n_edges / 2 + 2));
+    b->edges = malloc(sizeof(uint) * (n_edges + 1));
+    b->top = malloc(sizeof(uint) * (n_edges / 2 + 1));
+    b->comp_2ecc = malloc(sizeof(uint) * (g->v_num + 1));
+    if (!s.stack || !s.next || !s.parent || !s.level || !s.low || !s.state || !s.is_cut
+        || !s.edge_stack || !s.vert_stack || !b->edge_off || !b->edges || !b->top
+        || !b->comp_2ecc) {
+        fprintf(stderr, "Erro set_cut: nao foi possivel alocar pilha da busca\n");
+        exit(EXIT_FAILURE);
+    }
+    STATS_PEAK(g, sizeof(uint) * (7 * (size_t)g->v_num + 2 * (size_t)n_edges + 11)
+            + 2 * ((size_t)g->v_num + 1));
+    s.n_edges = 0;
+    s.n_verts = 0;
+    b->edge_off[0] = 0;
+
+    for (uint i = 0; i < g->v_num; i++) {
+        if (s.state[i] == 0)
+            low_point(g, i, &s);
+    }
+
+    set_block_cuts(g, s.is_cut);
+
+    free(s.stack);
+    free(s.next);
+    free(s.parent);
+    free(s.level);
+    free(s.low);
+    free(s.state);
+    free(s.is_cut);
+    free(s.edge_stack);
+    free(s.vert_stack);
+    STATS_STOP(g->stats.cortes, start);
+}
+
+// compares two items of kind ITEM_VERTEX or ITEM_EDGE by their text, the names of their
+// vertices separated by a space
+int comp_named(const void* a, const void* b)
+{
+    const named_item* x = *(const named_item* const*)a;
+    const named_item* y = *(const named_item* const*)b;
+    int c = strcmp(x->name[0], y->name[0]);
+
+    if (c == 0)
+        return x->name[1] ? strcmp(x->name[1], y->name[1]) : 0;
+
+    // a first name that is a prefix of the other is followed by the space, which sorts
+    // after the next character of the other only if that one is a control character
+    if (x->name[1] && (x->len != y->len)) {
+        const named_item* s = (x->len < y->len) ? x : y;
+        const named_item* l = (x->len < y->len) ? y : x;
+
+        if (((unsigned char)l->name[0][s->len] < ' ') && !memcmp(s->name[0], l->name[0], s->len))
+            return (s == x) ? 1 : -1;
+    }
+
+    return c;
+}
+
+// auxiliary function to compare numbers
+int comp_uint(const void* a, const void* b)
+{
+    uint n1 = *(const uint*)a;
+    uint n2 = *(const uint*)b;
+
+    return (n1 > n2) - (n1 < n2);
+}
+
+// puts the items of list in output order, unless they are still sorted from a previous
+// query: vertices and edges by their text, each edge with its ends in alphabetic order,
+// and numbers in non-decreasing order
+void sort_items(grafo* g, uint_list* list, uint kind)
+{
+    uint width = (kind == ITEM_EDGE) ? 2 : 1;
+    uint n = list->size / width;
+    named_item* items;
+    named_item** order;
+
+    if (list->sorted)
+        return;
+    list->sorted = 1;
+
+    // an empty list may have no array, which qsort must not get even with no items
+    if (n == 0)
+        return;
+
+    if (kind == ITEM_NUMBER) {
+        qsort(list->v, n, sizeof(uint), comp_uint);
+        return;
+    }
+
+    // qsort takes no context, so the names are gathered next to the indices, and
+    // pointers to them are sorted, which moves less memory than the items themselves
+    if (!(items = malloc(sizeof(named_item) * (n + 1)))
+        || !(order = malloc(sizeof(named_item*) * (n + 1)))) {
+        fprintf(stderr, "Erro sort_items: nao foi possivel alocar lista de nomes\n");
+        exit(EXIT_FAILURE);
+    }
+    for (uint i = 0; i < n; i++) {
+        uint a = list->v[width * i];
+        uint b = (width == 2) ? list->v[width * i + 1] : a;
+
+        if ((width == 2) && (strcmp(g->v_name[b], g->v_name[a]) < 0)) {
+            b = a;
+            a = list->v[width * i + 1];
+        }
+        items[i].id[0] = a;
+        items[i].id[1] = b;
+        items[i].name[0] = g->v_name[a];
+        items[i].name[1] = (width == 2) ? g->v_name[b] : NULL;
+        items[i].len = (width == 2) ? (uint)strlen(items[i].name[0]) : 0;
+        order[i] = &items[i];
+    }
+
+    qsort(order, n, sizeof(named_item*), comp_named);
+
+    for (uint i = 0; i < n; i++) {
+        list->v[width * i] = order[i]->id[0];
+        if (width == 2)
+            list->v[width * i + 1] = order[i]->id[1];
+    }
+
+    free(items);
+    free(order);
+}
+
+// writes the text of the item at 'item' to 'out', without a final '\0', and returns its
+// length; with out NULL only returns the length
+size_t item_text(grafo* g, const uint* item, uint kind, char* out)
+{
+    char buffer[16];
+    const char* name;
+    size_t len;
+
+    if (kind == ITEM_NUMBER) {
+        len = (size_t)snprintf(buffer, sizeof(buffer), "%u", item[0]);
+        if (out)
+            memcpy(out, buffer, len);
+        return len;
+    }
+
+    name = g->v_name[item[0]];
+    len = strlen(name);
+    if (out)
+        memcpy(out, name, len);
+    if (kind == ITEM_VERTEX)
+        return len;
+
+    name = g->v_name[item[1]];
+    if (out) {
+        out[len] = ' ';
+        memcpy(out + len + 1, name, strlen(name));
+    }
+
+    return len + 1 + strlen(name);
+}
+
+// creates a string with the text of the items of 'list', sorted, separated by spaces
+// the length is found first, so the names are copied once into a single allocation
+char* create_str_from_items(grafo* g, uint_list* list, uint kind)
+{
+    uint width = (kind == ITEM_EDGE) ? 2 : 1;
+    size_t total_len = 1;
+    char *string, *end;
+
+    sort_items(g, list, kind);
+
+    // calcluates total size of output string
+    for (uint i = 0; i < list->size; i += width)
+        total_len += item_text(g, list->v + i, kind, NULL) + 1;
+
+    // allocate string
+    if (!(string = malloc(sizeof(char) * total_len)))
+        return NULL;
+
+    // copies the items one after the other, keeping the end of the string
+    end = string;
+    for (uint i = 0; i < list->size; i += width) {
+        if (i > 0)
+            *end++ = ' ';
+        end += item_text(g, list->v + i, kind, end);
+    }
+    *end = '\0';
+
+    return string;
+}
+
+// writes the items of list to f in output order, separated by spaces
+// returns 1 if every write succeeded
+uint write_items(FILE* f, grafo* g, uint_list* list, uint kind)
+{
+    uint width = (kind == ITEM_EDGE) ? 2 : 1;
+
+    sort_items(g, list, kind);
+
+    for (uint i = 0; i < list->size; i += width) {
+        if ((i > 0) && (fputc(' ', f) == EOF))
+            return 0;
+
+        if (kind == ITEM_NUMBER) {
+            if (fprintf(f, "%u", list->v[i]) < 0)
+                return 0;
+        } else if (fputs(g->v_name[list->v[i]], f) == EOF)
+            return 0;
+
+        if ((kind == ITEM_EDGE)
+            && ((fputc(' ', f) == EOF) || (fputs(g->v_name[list->v[i + 1]], f) == EOF)))
+            return 0;
+    }
+
+    return !ferror(f);
+}
+
+// calls visita for the items of list in output order, until it returns something other
+// than 0; returns the number of items visited
+// vertices are given by their names in g, the other items are written to a buffer that
+// is reused from one call to the next
+uint visit_items(grafo* g, uint_list* list, uint kind,
+    int (*visita)(const char* item, void* dados), void* dados)
+{
+    uint width = (kind == ITEM_EDGE) ? 2 : 1;
+    char* buffer = NULL;
+    size_t max = 0;
+    uint n = 0;
+
+    sort_items(g, list, kind);
+
+    for (uint i = 0; i < list->size; i += width) {
+        const char* item;
+
+        if (kind == ITEM_VERTEX)
+            item = g->v_name[list->v[i]];
+        else {
+            size_t len = item_text(g, list->v + i, kind, NULL);
+            if (len + 1 > max) {
+                max = 2 * len + 16;
+                if (!(buffer = realloc(buffer, max))) {
+                    fprintf(stderr, "Erro visit_items: nao foi possivel alocar item\n");
+                    exit(EXIT_FAILURE);
+                }
+            }
+            item_text(g, list->v + i, kind, buffer);
+            buffer[len] = '\0';
+            item = buffer;
+        }
+
+        n++;
+        if (visita(item, dados))
+            break;
+    }
+
+    free(buffer);
+
+    return n;
+}
+
+// copies the items of list, in output order, to 'out' if it is not NULL
+// returns the number of items
+uint copy_items(grafo* g, uint_list* list, uint kind, uint* out)
+{
+    uint width = (kind == ITEM_EDGE) ? 2 : 1;
+
+    if (out && (list->size > 0)) {
+        sort_items(g, list, kind);
+        memcpy(out, list->v, sizeof(uint) * list->size);
+    }
+
+    return list->size / width;
+}
+
+// generates 'name', a shortest path kernel that sets in h->dist the distance from vertex
+// 'r' of every vertex in the same component as r and returns the largest of them (the
+// eccentricity of r). 'push', 'pop' and 'decrease' are the operations of its queue and
+// 'weight' is the weight of the adjacency entry k, so each kernel gets its own inner loop
+// the distances of the previous run of 'h' are cleared first
+#define MAX_DIST_KERNEL(name, push, pop, decrease, weight)                                     \
+    uint name(grafo* g, uint r, heap_t* h)                                                     \
+    {                                                                                          \
+        uint v, w, d, max_dist = 0;                                                            \
+                                                                                               \
+        for (uint i = 0; i < h->n_reached; i++)                                                \
+            h->dist[h->reached[i]] = UINT_MAX;                                                 \
+        h->n_reached = 0;                                                                      \
+        h->base = 0;                                                                           \
+                                                                                               \
+        h->dist[r] = 0;                                                                        \
+        h->reached[h->n_reached++] = r;                                                        \
+        push(h, r);                                                                            \
+                                                                                               \
+        while (h->size != 0) {                                                                 \
+            v = pop(h);                                                                        \
+            max_dist = h->dist[v];                                                             \
+                                                                                               \
+            for (uint k = g->adj_off[v]; k < g->adj_off[v + 1]; k++) {                         \
+                STATS_INC(h->relaxed);                                                         \
+                w = g->adj[k];                                                                 \
+                d = h->dist[v] + (weight);                                                     \
+                /* the queue is only touched when the distance drops */                        \
+                if (d >= h->dist[w])                                                           \
+                    continue;                                                                  \
+                                                                                               \
+                if (h->dist[w] == UINT_MAX) {                                                  \
+                    h->dist[w] = d;                                                            \
+                    h->reached[h->n_reached++] = w;                                            \
+                    push(h, w);                                                                \
+                } else {                                                                       \
+                    h->dist[w] = d;                                                            \
+                    decrease(h, w);                                                            \
+                }                                                                              \
+            }                                                                                  \
+        }                                                                                      \
+                                                                                               \
+        return max_dist;                                                                       \
+    }
+
+MAX_DIST_KERNEL(dijkstra_max_dist, heap_append_vertex, heap_pop_vertex, heap_decrease_key,
+    g->adj_w[k])
+// shortest path kernel for unit weights: the distances are the levels of a BFS from r
+uint bfs_max_dist(grafo* g, uint r, heap_t* h)
+{
+    bfs_t* b = &h->bfs;
+
+    if (b->seen == NULL) {
+        // h->dist starts at UINT_MAX and h->reached is empty, as bfs_reset leaves them
+        bfs_init(b, g, h->dist, h->reached);
+#ifdef GRAFO_STATS
+        h->bytes += sizeof(unsigned long long) * 2 * ((size_t)b->n_words + 1);
+#endif
+    } else
+        bfs_reset(b, g);
+
+    uint max_dist = bfs_run(g, b, r);
+    h->n_reached = b->n_queued;
+    STATS_ADD(h->pushes, b->n_queued);
+    STATS_ADD(h->pops, b->n_queued);
+#ifdef GRAFO_STATS
+    h->relaxed += b->scanned;
+    b->scanned = 0;
+#endif
+
+    return max_dist;
+}
+
+MAX_DIST_KERNEL(dial_max_dist, dial_push, dial_pop, dial_decrease_key, g->adj_w[k])
+MAX_DIST_KERNEL(radix_max_dist, radix_push, radix_pop, radix_decrease_key, g->adj_w[k])
+
+// thread that runs Dijkstra from the sources taken from the shared cursor of its
+// diameter_worker, keeping the largest eccentricity of each component
+void* diameter_thread(void* arg)
+{
+    diameter_worker* w = arg;
+    grafo* g = w->g;
+    uint first, max_dist;
+
+    while ((first = __atomic_fetch_add(w->cursor, SOURCE_BATCH, __ATOMIC_RELAXED)) < g->v_num) {
+        for (uint i = first; (i < first + SOURCE_BATCH) && (i < g->v_num); i++) {
+            max_dist = g->max_dist(g, i, w->h);
+            if (max_dist > w->diametro[g->component[i] - 1])
+                w->diametro[g->component[i] - 1] = max_dist;
+        }
+    }
+
+    return NULL;
+}
+
+// sets in 'diametro' the diameter of each component running Dijkstra from every vertex
+// the runs are spread over the graph's threads
+void all_sources_diameters(grafo* g, uint* diametro)
+{
+    diameter_worker* workers;
+    uint n_threads = thread_count(g->n_threads);
+    uint cursor = 0;
+
+    if (n_threads > g->v_num / MIN_THREAD_VERTS + 1)
+        n_threads = g->v_num / MIN_THREAD_VERTS + 1;
+
+    if (!(workers = malloc(sizeof(diameter_worker) * n_threads))) {
+        fprintf(stderr, "Erro all_sources_diameters: nao foi possivel alocar threads\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // each thread has its own heap (and distances) and its own diameters
+    workers[0].diametro = diametro;
+    for (uint t = 0; t < n_threads; t++) {
+        workers[t].g = g;
+        workers[t].cursor = &cursor;
+        workers[t].h = heap_create(g->v_num, g->n_buckets);
+        if ((t > 0) && !(workers[t].diametro = calloc(g->n_componentes + 1, sizeof(uint)))) {
+            fprintf(stderr,
+                "Erro all_sources_diameters: nao foi possivel alocar lista de diametros\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    STATS_PEAK(g, n_threads * workers[0].h->bytes);
+
+    run_threads(diameter_thread, workers, sizeof(diameter_worker), n_threads);
+
+    // the diameter of a component is the largest eccentricity of its vertices
+    for (uint t = 1; t < n_threads; t++) {
+        for (uint c = 0; c < g->n_componentes; c++)
+            if (workers[t].diametro[c] > diametro[c])
+                diametro[c] = workers[t].diametro[c];
+        free(workers[t].diametro);
+    }
+
+    for (uint t = 0; t < n_threads; t++) {
+        STATS_HEAP(g, workers[t].h);
+        heap_free(workers[t].h);
+    }
+    free(workers);
+
+    g->n_sssp = g->v_num;
+}
+
+// sets in 'diametro' the diameter of each component from bounds on the eccentricities
+// of its vertices (Takes and Kosters, "Determining the diameter of small world networks")
+//
+// after a run from s, every w in the component has max(d(s,w), ecc(s) - d(s,w)) <= ecc(w)
+// <= ecc(s) + d(s,w). A vertex whose upper bound is not above the largest lower bound
+// cannot have a larger eccentricity and stops being a candidate; sources alternate
+// between the candidates with the largest upper bound and the smallest lower bound
+void bounded_diameters(grafo* g, uint* diametro)
+{
+    uint *order, *start, *lower, *upper;
+    uint *cand, n_cand, best, s, w, d, l, u, ecc, diam;
+    int pick_upper;
+    heap_t* h;
+
+    order = malloc(sizeof(uint) * (g->v_num + 1));
+    start = malloc(sizeof(uint) * (g->n_componentes + 2));
+    lower = malloc(sizeof(uint) * (g->v_num + 1));
+    upper = malloc(sizeof(uint) * (g->v_num + 1));
+    if (!order || !start || !lower || !upper) {
+        fprintf(stderr, "Erro bounded_diameters: nao foi possivel alocar limites\n");
+        exit(EXIT_FAILURE);
+    }
+
+    group_by_component(g, order, start);
+
+    h = heap_create(g->v_num, g->n_buckets);
+    STATS_PEAK(g, h->bytes + sizeof(uint) * 3 * (size_t)g->v_num);
+    g->n_sssp = 0;
+
+    for (uint c = 1; c <= g->n_componentes; c++) {
+        cand = order + start[c];
+        n_cand = start[c + 1] - start[c];
+        diam = 0;
+        pick_upper = 1;
+
+        for (uint i = 0; i < n_cand; i++) {
+            lower[cand[i]] = 0;
+            upper[cand[i]] = UINT_MAX;
+        }
+
+        // an isolated vertex has eccentricity 0
+        while (n_cand > 1) {
+            // ties go to the vertex of largest degree
+            best = 0;
+            for (uint i = 1; i < n_cand; i++) {
+                w = cand[i];
+                s = cand[best];
+                if (pick_upper ? (upper[w] < upper[s]) : (lower[w] > lower[s]))
+                    continue;
+                if ((pick_upper ? (upper[w] > upper[s]) : (lower[w] < lower[s]))
+                    || (g->adj_off[w + 1] - g->adj_off[w] > g->adj_off[s + 1] - g->adj_off[s]))
+                    best = i;
+            }
+            s = cand[best];
+            pick_upper = !pick_upper;
+
+            ecc = g->max_dist(g, s, h);
+            g->n_sssp++;
+
+            for (uint i = 0; i < h->n_reached; i++) {
+                w = h->reached[i];
+                d = h->dist[w];
+                l = (d > ecc - d) ? d : ecc - d;
+                u = (ecc > UINT_MAX - d) ? UINT_MAX : ecc + d;
+                if (l > lower[w])
+                    lower[w] = l;
+                if (u < upper[w])
+                    upper[w] = u;
+                if (lower[w] > diam)
+                    diam = lower[w];
+            }
+            upper[s] = ecc;
+
+            // keeps only the vertices that may have an eccentricity above diam
+            uint kept = 0;
+            for (uint i = 0; i < n_cand; i++)
+                if (upper[cand[i]] > diam)
+                    cand[kept++] = cand[i];
+            n_cand = kept;
+        }
+
+        diametro[c - 1] = diam;
+    }
+
+    STATS_HEAP(g, h);
+    heap_free(h);
+    free(order);
+    free(start);
+    free(lower);
+    free(upper);
+}
+
+// sets in 'lower' and 'upper' bounds for the diameter of each component from 'sweeps'
+// Dijkstra runs per component, each from the vertex farthest from the previous source
+// (k-sweep). The first source is pseudo-peripheral: the vertex farthest from the
+// component's vertex of smallest index, found by one more run whose distances also
+// count for the bounds
+//
+// every eccentricity found is a lower bound; ecc(w) <= ecc(s) + d(s,w) for every source
+// s, so the largest of the smallest of these sums over the sources is an upper bound,
+// never above twice the eccentricity of any source
+void sweep_diameters(grafo* g, uint sweeps, uint* lower, uint* upper)
+{
+    uint *order, *start, *bound, *sources;
+    uint *comp, n_comp, n_sources, s, w, u, ecc, far;
+    heap_t* h;
+
+    order = malloc(sizeof(uint) * (g->v_num + 1));
+    start = malloc(sizeof(uint) * (g->n_componentes + 2));
+    bound = malloc(sizeof(uint) * (g->v_num + 1));
+    sources = malloc(sizeof(uint) * (sweeps + 1));
+    if (!order || !start || !bound || !sources) {
+        fprintf(stderr, "Erro sweep_diameters: nao foi possivel alocar limites\n");
+        exit(EXIT_FAILURE);
+    }
+
+    group_by_component(g, order, start);
+
+    h = heap_create(g->v_num, g->n_buckets);
+    STATS_PEAK(g, h->bytes + sizeof(uint) * 3 * (size_t)g->v_num);
+
+    for (uint c = 1; c <= g->n_componentes; c++) {
+        comp = order + start[c];
+        n_comp = start[c + 1] - start[c];
+        lower[c - 1] = 0;
+        upper[c - 1] = 0;
+
+        // an isolated vertex has eccentricity 0
+        if (n_comp == 1)
+            continue;
+
+        for (uint i = 0; i < n_comp; i++)
+            bound[comp[i]] = UINT_MAX;
+
+        // the run from comp[0] only looks for the first sweep's source
+        s = comp[0];
+        n_sources = 0;
+        while (n_sources < sweeps + 1) {
+            sources[n_sources++] = s;
+            ecc = g->max_dist(g, s, h);
+            if (ecc > lower[c - 1])
+                lower[c - 1] = ecc;
+
+            far = s;
+            for (uint i = 0; i < h->n_reached; i++) {
+                w = h->reached[i];
+                u = (ecc > UINT_MAX - h->dist[w]) ? UINT_MAX : ecc + h->dist[w];
+                if (u < bound[w])
+                    bound[w] = u;
+                // ties go to the smallest index, so that the sources, and the bounds,
+                // do not depend on the order in which the kernel reaches the vertices
+                if ((h->dist[w] > h->dist[far]) || ((h->dist[w] == h->dist[far]) && (w < far)))
+                    far = w;
+            }
+
+            // sweeping again from a previous source gives nothing new
+            s = far;
+            uint seen = 0;
+            for (uint i = 0; i < n_sources; i++)
+                if (sources[i] == s)
+                    seen = 1;
+            if (seen)
+                break;
+        }
+
+        for (uint i = 0; i < n_comp; i++)
+            if (bound[comp[i]] > upper[c - 1])
+                upper[c - 1] = bound[comp[i]];
+    }
+
+    STATS_HEAP(g, h);
+    heap_free(h);
+    free(order);
+    free(start);
+    free(bound);
+    free(sources);
+}
+
+// fills 'order' with the vertices of g grouped by component: those of component c are
+// order[start[c]] ... order[start[c + 1] - 1], in increasing index order. 'start' must
+// have room for n_componentes + 2 elements
+void group_by_component(grafo* g, uint* order, uint* start)
+{
+    for (uint c = 0; c <= g->n_componentes + 1; c++)
+        start[c] = 0;
+    for (uint i = 0; i < g->v_num; i++)
+        start[g->component[i]]++;
+    for (uint c = 1; c <= g->n_componentes; c++)
+        start[c] += start[c - 1];
+    for (uint i = g->v_num; i-- > 0;)
+        order[--start[g->component[i]]] = i;
+    start[g->n_componentes + 1] = g->v_num;
+}
+
+// calculates diameters of every component and saves them to the graph
+void set_diameters(grafo* g)
+{
+    uint* diametro;
+    STATS_START(start);
+
+    if (!(diametro = calloc(g->n_componentes + 1, sizeof(uint)))) {
+        fprintf(stderr, "Erro set_diameters: nao foi possivel alocar lista de diametros\n");
+        exit(EXIT_FAILURE);
+    }
+    g->diametros.size = 0;
+
+    if (g->diameter_mode == DIAMETRO_TODAS_ORIGENS)
+        all_sources_diameters(g, diametro);
+    else
+        bounded_diameters(g, diametro);
+
+    // armazena informacao do diametro
+    for (uint c = 0; c < g->n_componentes; c++)
+        add_uint(&g->diametros, diametro[c]);
+
+    free(diametro);
+    STATS_STOP(g->stats.diametros, start);
+}
+
+// Creates a heap with room for the vertices 0 ... capacity - 1
+heap_t* heap_create(uint capacity, uint n_buckets)
+{
+    heap_t* h;
+
+    if (!(h = malloc(sizeof(heap_t)))) {
+        fprintf(stderr, "Erro heap_create: nao foi possivel alocar heap\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (!(h->items = malloc(sizeof(uint) * capacity + 1))
+        || !(h->pos = malloc(sizeof(uint) * capacity + 1))
+        || !(h->dist = malloc(sizeof(uint) * capacity + 1))
+        || !(h->reached = malloc(sizeof(uint) * capacity + 1))) {
+        fprintf(stderr, "Erro heap_create: nao foi possivel alocar itens da heap\n");
+        exit(EXIT_FAILURE);
+    }
+
+    for (uint i = 0; i < capacity; i++) {
+        h->pos[i] = NOT_IN_HEAP;
+        h->dist[i] = UINT_MAX;
+    }
+
+    h->next = h->prev = h->heads = NULL;
+    if ((n_buckets > 0)
+        && (!(h->next = malloc(sizeof(uint) * capacity + 1))
+            || !(h->prev = malloc(sizeof(uint) * capacity + 1))
+            || !(h->heads = malloc(sizeof(uint) * n_buckets)))) {
+        fprintf(stderr, "Erro heap_create: nao foi possivel alocar baldes da heap\n");
+        exit(EXIT_FAILURE);
+    }
+    for (uint b = 0; b < n_buckets; b++)
+        h->heads[b] = NOT_IN_HEAP;
+
+    h->bfs.seen = h->bfs.frontier = NULL;
+    h->n_buckets = n_buckets;
+    h->base = 0;
+    h->n_reached = 0;
+    h->size = 0;
+    h->capacity = capacity;
+#ifdef GRAFO_STATS
+    h->pushes = h->pops = h->decreases = h->relaxed = 0;
+    h->bytes = sizeof(uint) * ((n_buckets > 0) ? 6 : 4) * ((size_t)capacity + 1)
+        + sizeof(uint) * n_buckets;
+#endif
+
+    return h;
+}
+
+// detroys heap
+void heap_free(heap_t* h)
+{
+    free(h->items);
+    free(h->pos);
+    free(h->dist);
+    free(h->reached);
+    free(h->next);
+    free(h->prev);
+    free(h->heads);
+    bfs_free(&h->bfs);
+    free(h);
+}
+
+// updates heap upwards from idx
+void heapify_up(heap_t* h, uint idx)
+{
+    uint v = h->items[idx];
+
+    while (idx > 0) {
+        uint parent = (idx - 1) / 2;
+        if (h->dist[h->items[parent]] <= h->dist[v])
+            break;
+        h->items[idx] = h->items[parent];
+        h->pos[h->items[idx]] = idx;
+        idx = parent;
+    }
+
+    h->items[idx] = v;
+    h->pos[v] = idx;
+}
+
+// updates heap downwards from idx
+void heapify_down(heap_t* h, uint idx)
+{
+    uint v = h->items[idx];
+
+    while (1) {
+        uint left = 2 * idx + 1;
+        uint right = 2 * idx + 2;
+        uint smallest = left;
+
+        if (left >= h->size)
+            break;
+        if (right < h->size && h->dist[h->items[right]] < h->dist[h->items[left]])
+            smallest = right;
+        if (h->dist[v] <= h->dist[h->items[smallest]])
+            break;
+
+        h->items[idx] = h->items[smallest];
+        h->pos[h->items[idx]] = idx;
+        idx = smallest;
+    }
+
+    h->items[idx] = v;
+    h->pos[v] = idx;
+}
+
+// appends vertex to heap, keyed by its current distance
+void heap_append_vertex(heap_t* h, uint v)
+{
+    STATS_INC(h->pushes);
+    if (h->size >= h->capacity) {
+        fprintf(stderr, "Erro heap_append_vertex: heap cheia\n");
+        exit(EXIT_FAILURE);
+    }
+
+    h->items[h->size] = v;
+    heapify_up(h, h->size);
+    h->size++;
+}
+
+// pops min vertex from heap
+uint heap_pop_vertex(heap_t* h)
+{
+    STATS_INC(h->pops);
+    if (h->size == 0) {
+        fprintf(stderr, "Erro heap_pop_vertex: heap vazia\n");
+        exit(EXIT_FAILURE);
+    }
+    uint min = h->items[0];
+    h->pos[min] = NOT_IN_HEAP;
+    h->size--;
+    if (h->size > 0) {
+        h->items[0] = h->items[h->size];
+        heapify_down(h, 0);
+    }
+    return min;
+}
+
+// restores the heap after the distance of v, which is in the heap, decreased
+void heap_decrease_key(heap_t* h, uint v)
+{
+    STATS_INC(h->decreases);
+    heapify_up(h, h->pos[v]);
+}
+
+// puts vertex v in front of the list of bucket b
+void bucket_link(heap_t* h, uint v, uint b)
+{
+    h->next[v] = h->heads[b];
+    h->prev[v] = NOT_IN_HEAP;
+    if (h->heads[b] != NOT_IN_HEAP)
+        h->prev[h->heads[b]] = v;
+    h->heads[b] = v;
+    h->pos[v] = b;
+}
+
+// removes vertex v from the list of its bucket
+void bucket_unlink(heap_t* h, uint v)
+{
+    if (h->prev[v] != NOT_IN_HEAP)
+        h->next[h->prev[v]] = h->next[v];
+    else
+        h->heads[h->pos[v]] = h->next[v];
+    if (h->next[v] != NOT_IN_HEAP)
+        h->prev[h->next[v]] = h->prev[v];
+    h->pos[v] = NOT_IN_HEAP;
+}
+
+// appends vertex to Dial's bucket queue, keyed by its current distance
+// the queued distances lie in [base, base + largest weight], so they never share a bucket
+void dial_push(heap_t* h, uint v)
+{
+    STATS_INC(h->pushes);
+    bucket_link(h, v, h->dist[v] & (h->n_buckets - 1));
+    h->size++;
+}
+
+// pops a vertex of smallest distance from Dial's bucket queue
+uint dial_pop(heap_t* h)
+{
+    uint v;
+
+    STATS_INC(h->pops);
+    while (h->heads[h->base & (h->n_buckets - 1)] == NOT_IN_HEAP)
+        h->base++;
+
+    v = h->heads[h->base & (h->n_buckets - 1)];
+    bucket_unlink(h, v);
+    h->size--;
+
+    return v;
+}
+
+// moves v, which is in Dial's bucket queue, to the bucket of its new distance
+void dial_decrease_key(heap_t* h, uint v)
+{
+    STATS_INC(h->decreases);
+    bucket_unlink(h, v);
+    bucket_link(h, v, h->dist[v] & (h->n_buckets - 1));
+}
+
+// returns the radix heap bucket of distance 'key': 0 if it equals base, otherwise one
+// plus the highest bit in which they differ
+uint radix_bucket(heap_t* h, uint key)
+{
+    if (key == h->base)
+        return 0;
+
+    return 32 - (uint)__builtin_clz(key ^ h->base);
+}
+
+// appends vertex to the radix heap, keyed by its current distance
+void radix_push(heap_t* h, uint v)
+{
+    STATS_INC(h->pushes);
+    bucket_link(h, v, radix_bucket(h, h->dist[v]));
+    h->size++;
+}
+
+// pops a vertex of smallest distance from the radix heap
+// when bucket 0 is empty, base becomes the smallest distance of the first nonempty bucket
+// and its vertices are spread over the buckets below it
+uint radix_pop(heap_t* h)
+{
+    uint v, next, b = 0;
+
+    STATS_INC(h->pops);
+    if (h->heads[0] == NOT_IN_HEAP) {
+        while (h->heads[b] == NOT_IN_HEAP)
+            b++;
+
+        h->base = UINT_MAX;
+        for (v = h->heads[b]; v != NOT_IN_HEAP; v = h->next[v])
+            if (h->dist[v] < h->base)
+                h->base = h->dist[v];
+
+        v = h->heads[b];
+        h->heads[b] = NOT_IN_HEAP;
+        for (; v != NOT_IN_HEAP; v = next) {
+            next = h->next[v];
+            bucket_link(h, v, radix_bucket(h, h->dist[v]));
+        }
+    }
+
+    v = h->heads[0];
+    bucket_unlink(h, v);
+    h->size--;
 
-    destroy_queue(&queue);
-    return c;
+    return v;
 }
 
-// searches vertice of name 'name' in the list 'V' of size 'size'
-// returns index of vertex in the list
-long long int search_vert(vertice* V, uint size, char* name)
+// moves v, which is in the radix heap, to the bucket of its new distance
+void radix_decrease_key(heap_t* h, uint v)
 {
-    for (uint i = 0; i < size; i++) {
-        if (strcmp(V[i].name, name) == 0)
-            return i;
-    }
-
-    return -1;
+    STATS_INC(h->decreases);
+    bucket_unlink(h, v);
+    bucket_link(h, v, radix_bucket(h, h->dist[v]));
 }
 
-// creates a node of type neighbor of index idx with wheight 'weight'
-neighbor* create_neighbor(uint idx, uint weight)
+// brings the union-find up to the vertices of g, each new vertex in a set of its own
+// the first call puts every edge already in g in the structure
+void dsu_grow(grafo* g)
 {
-    neighbor* neigh;
+    dsu_t* d = &g->dsu;
+    uint first = (d->parent == NULL);
+
+    if (g->v_num > d->max) {
+        d->max = (g->v_num > 2 * d->max) ? g->v_num : 2 * d->max;
+        if (!(d->parent = realloc(d->parent, sizeof(uint) * d->max))
+            || !(d->rank = realloc(d->rank, d->max)) || !(d->parity = realloc(d->parity, d->max))
+            || !(d->size = realloc(d->size, sizeof(uint) * d->max))) {
+            fprintf(stderr, "Erro dsu_grow: nao foi possivel alocar conjuntos\n");
+            exit(EXIT_FAILURE);
+        }
+    }
 
-    if (!(neigh = malloc(sizeof(neighbor))))
-        return NULL;
+    for (uint v = d->n; v < g->v_num; v++) {
+        d->parent[v] = v;
+        d->rank[v] = 0;
+        d->parity[v] = 0;
+        d->size[v] = 1;
+        d->sets++;
+    }
+    d->n = g->v_num;
 
-    // node->name = name;
-    neigh->idx = idx;
-    neigh->weight = weight;
-    neigh->next = NULL;
+    if (!first)
+        return;
 
-    return neigh;
+    for (uint v = 0; (g->adj_off != NULL) && (v < g->adj_v_num); v++)
+        for (uint k = g->adj_off[v]; k < g->adj_off[v + 1]; k++)
+            if (g->adj[k] >= v)
+                dsu_union(d, v, g->adj[k]);
+    for (uint i = 0; i < g->staged.size; i++)
+        dsu_union(d, g->staged.e[i].a, g->staged.e[i].b);
 }
 
-// adds a vertice with name 'name' to the list 'V' of current size 'size' and maximum
-// size 'max', adding one to the current size variable. if theres no space left in then list,
-// reallocates it and alters 'max' accordingly
-long long int add_vert(vertice** V, uint* size, uint* max, char* name)
+// returns the root of the set of v and sets in 'parity' the parity of v relative to it
+// the path from v is compressed, every vertex on it pointing straight to the root
+uint dsu_find(dsu_t* d, uint v, uint* parity)
 {
-    long long idx = search_vert(*V, *size, name);
-    uint new_max;
+    uint root = v, p = 0;
 
-    if (idx == -1) {
-        if (*size >= *max) {
-            if (*max == 0) {
-                *V = NULL;
-                *max = STARTING_VERT_NUM;
-                new_max = *max;
-            } else
-                new_max = *max * 2;
-
-            if (!(*V = realloc(*V, sizeof(vertice) * new_max))) {
-                fprintf(stderr, "Erro add_vert: nao foi possivel realocar lista de vertices\n");
-                exit(EXIT_FAILURE);
-            }
+    while (d->parent[root] != root) {
+        p ^= d->parity[root];
+        root = d->parent[root];
+    }
 
-            *max = new_max;
+    // x_p is the parity of x relative to the root
+    for (uint x = v, x_p = p; d->parent[x] != root && x != root;) {
+        uint next = d->parent[x];
+        uint next_p = x_p ^ d->parity[x];
+        d->parent[x] = root;
+        d->parity[x] = (unsigned char)x_p;
+        x = next;
+        x_p = next_p;
+    }
 
-            // sets every new vertice
-            for (uint i = *size; i < *max; i++) {
-                (*V)[i].name = NULL;
-                (*V)[i].n_list = NULL;
-                (*V)[i].n_num = 0;
-            }
-        }
-        (*size)++;
-        (*V)[*size - 1].name = name;
-        return *size - 1;
-    } else // if vertice is already in the list, dont do anything
-        return idx;
+    *parity = p;
+    return root;
 }
 
-// adds vertice of name 'name' to the graph's vertex list
-// returns its index in the list
-long long int add_graph_vert(grafo* g, char* name)
+// joins the sets of a and b by the edge {a, b}, which puts them on different sides
+// an edge inside a set between vertices of the same parity closes an odd cycle
+void dsu_union(dsu_t* d, uint a, uint b)
 {
-    return add_vert(&(g->v), &g->v_num, &g->max_v_num, name);
-}
+    uint pa, pb;
+    uint ra = dsu_find(d, a, &pa);
+    uint rb = dsu_find(d, b, &pb);
 
-// adds to the neighbor list of the vertice of index 'v_idx' a neighbor with index
-// 'neigh_idx' and given weight.
-neighbor* add_neighbor(grafo* g, uint v_idx, uint neigh_idx, uint weight)
-{
-    neighbor* new_neigh = create_neighbor(neigh_idx, weight);
+    if (ra == rb) {
+        if (pa == pb)
+            d->odd = 1;
+        return;
+    }
 
-    if (g->v[v_idx].n_list == NULL) {
-        g->v[v_idx].n_list = new_neigh;
-    } else {
-        struct neighbor* neigh = g->v[v_idx].n_list;
-        // search end of linked list
-        while (neigh->next != NULL) {
-            neigh = neigh->next;
-            // if vertice is already in the list of neighbors, return
-            if (strcmp(g->v[neigh->idx].name, g->v[neigh_idx].name) == 0)
-                return neigh;
-        }
+    // union by rank
+    if (d->rank[ra] < d->rank[rb]) {
+        uint t = ra;
+        ra = rb;
+        rb = t;
+    }
+    d->parent[rb] = ra;
+    d->parity[rb] = (unsigned char)(pa ^ pb ^ 1);
+    d->size[ra] += d->size[rb];
+    if (d->rank[ra] == d->rank[rb])
+        d->rank[ra]++;
+    d->sets--;
+}
 
-        neigh->next = new_neigh;
+// returns the root of the set of v in the union-find of label_components, which other
+// threads may be changing. The path is halved, each vertex on it pointing to its
+// grandparent; a vertex only ever points to a smaller one, so a lost update is harmless
+uint uf_find(uint* parent, uint v)
+{
+    uint p, gp;
+
+    while ((p = __atomic_load_n(&parent[v], __ATOMIC_RELAXED)) != v) {
+        gp = __atomic_load_n(&parent[p], __ATOMIC_RELAXED);
+        if (gp != p)
+            __atomic_compare_exchange_n(
+                &parent[v], &p, gp, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+        v = gp;
     }
-    (g->v[v_idx].n_num)++;
 
-    return new_neigh;
+    return v;
 }
 
-// destroys neighbor list
-void destroy_neighbor_list(neighbor* head)
+// joins the sets of a and b in the union-find of label_components, hooking the root of
+// larger index under the other one; the hook fails, and is tried again, if another
+// thread hooked that root first
+void uf_link(uint* parent, uint a, uint b)
 {
-    neighbor* neigh;
-
-    while (head != NULL) {
-        neigh = head->next;
-        free(head);
-        head = neigh;
+    uint t;
+
+    for (;;) {
+        a = uf_find(parent, a);
+        b = uf_find(parent, b);
+        if (a == b)
+            return;
+        if (a < b) {
+            t = a;
+            a = b;
+            b = t;
+        }
+        t = a;
+        if (__atomic_compare_exchange_n(&parent[a], &t, b, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            return;
     }
 }
 
-// destroys str_list
-void destroy_str_list(str_list list)
+// builds the block-cut forest of g from the blocks found by set_cut
+void bc_build(grafo* g)
 {
-    if (list.str == NULL)
-        return;
-    for (uint i = 0; i < list.size; i++)
-        free(list.str[i]);
-    free(list.str);
+    bc_forest* f = &g->bc;
+    blocks_t* b = &g->blocks;
+
+    bc_grow(g);
+
+    for (uint k = 0; k < b->n; k++) {
+        uint top = b->top[k];
+        uint id = bc_new_block(f, top);
+
+        // every vertex of the block other than its top is in no block closer to the root
+        f->n_blocks[top]++;
+        for (uint i = 2 * b->edge_off[k]; i < 2 * b->edge_off[k + 1]; i++) {
+            uint v = b->edges[i];
+            if ((v != top) && (f->up[v] == NO_BLOCK)) {
+                f->up[v] = id;
+                f->n_verts[id]++;
+            }
+        }
+    }
 }
 
-// creates a graph with given name
-grafo* create_graph(char* name)
+// brings the block-cut forest up to the vertices of g, each new vertex a tree of its own
+void bc_grow(grafo* g)
 {
-    grafo* g;
-
-    if (!(g = malloc(sizeof(grafo))))
-        return NULL;
-
-    g->name = name;
-
-    if (!(g->v = malloc(sizeof(vertice) * STARTING_VERT_NUM))) {
-        free(g);
-        return NULL;
+    bc_forest* f = &g->bc;
+
+    if (g->v_num > f->max_v) {
+        f->max_v = (g->v_num > 2 * f->max_v) ? g->v_num : 2 * f->max_v;
+        if (!(f->up = realloc(f->up, sizeof(uint) * f->max_v))
+            || !(f->n_blocks = realloc(f->n_blocks, sizeof(uint) * f->max_v))
+            || !(f->mark = realloc(f->mark, sizeof(uint) * f->max_v))) {
+            fprintf(stderr, "Erro bc_grow: nao foi possivel alocar floresta de blocos\n");
+            exit(EXIT_FAILURE);
+        }
     }
 
-    g->v_num = 0;
-    g->max_v_num = STARTING_VERT_NUM;
-    g->n_componentes = 0;
-
-    g->vertex_cut.str = NULL;
-    g->edge_cut.str = NULL;
-    g->vertex_cut.size = g->vertex_cut.max = 0;
-    g->edge_cut.size = g->edge_cut.max = 0;
-
-    for (uint i = 0; i < STARTING_VERT_NUM; i++) {
-        g->v[i].name = NULL;
-        g->v[i].n_list = NULL;
-        g->v[i].n_num = 0;
+    for (uint v = f->n_v; v < g->v_num; v++) {
+        f->up[v] = NO_BLOCK;
+        f->n_blocks[v] = 0;
+        f->mark[v] = 0;
     }
+    f->n_v = g->v_num;
+}
 
-    return g;
+// frees the arrays of the block-cut forest
+void bc_free(bc_forest* f)
+{
+    free(f->up);
+    free(f->n_blocks);
+    free(f->mark);
+    free(f->block);
+    free(f->top);
+    free(f->n_verts);
+    free(f->block_mark);
+    memset(f, 0, sizeof(bc_forest));
 }
 
-// parses string 'line' and sets 'x', 'y' and 'p' with the names of vertices and weight
-// presented in the string
-int parse_line(char* line, char** x, char** y, int* p)
+// adds to the forest a block with parent 'top' and no children, and returns it
+uint bc_new_block(bc_forest* f, uint top)
 {
-    char aux1[2048], aux2[2048];
-    *p = 1; // initialize with default value
+    if (f->n_b >= f->max_b) {
+        f->max_b = (f->max_b == 0) ? STARTING_VERT_NUM : 2 * f->max_b;
+        if (!(f->block = realloc(f->block, sizeof(uint) * f->max_b))
+            || !(f->top = realloc(f->top, sizeof(uint) * f->max_b))
+            || !(f->n_verts = realloc(f->n_verts, sizeof(uint) * f->max_b))
+            || !(f->block_mark = realloc(f->block_mark, sizeof(uint) * f->max_b))) {
+            fprintf(stderr, "Erro bc_new_block: nao foi possivel alocar blocos\n");
+            exit(EXIT_FAILURE);
+        }
+    }
 
-    // Parse the line
-    int res = sscanf(line, "%2047s -- %2047s %d", aux1, aux2, p);
+    uint b = f->n_b++;
+    f->block[b] = b;
+    f->top[b] = top;
+    f->n_verts[b] = 0;
+    f->block_mark[b] = 0;
 
-    if ((res == EOF) || res == 0)
-        return 0;
+    return b;
+}
 
-    if (!(*x = malloc(sizeof(char) * strlen(aux1) + 1))) {
-        return 0;
-    }
+// returns the block that block b was merged into, compressing the path to it
+uint bc_find(bc_forest* f, uint b)
+{
+    uint root = b;
 
-    if (!(*y = malloc(sizeof(char) * strlen(aux2) + 1))) {
-        free(*x);
-        return 0;
-    }
+    while (f->block[root] != root)
+        root = f->block[root];
 
-    strcpy(*x, aux1);
-    strcpy(*y, aux2);
+    while (f->block[b] != root) {
+        uint next = f->block[b];
+        f->block[b] = root;
+        b = next;
+    }
 
-    return res;
+    return root;
 }
 
-// reads file 'f' until a valid line is read (or EOF is found)
-// recieves a buffer 'line' with size 'size' and sets the buffer with the valid lilne.
-// If no valid line could be found, returns 0
-int get_valid_string(char* line, int size, FILE* f)
+// merges the blocks a and b, both roots of their sets, and returns the merged block
+// the caller sets its parent
+uint bc_union(bc_forest* f, uint a, uint b)
 {
-    while (1) {
-        // Read an entire line from input
-        if (!fgets(line, size, f))
-            return 0; // EOF or error
-        else if ((line[0] == '/')
-            || (line[0] == '\n')) // If the line stars with / or is empty, skip it
-            continue;
-        return 1;
+    if (f->n_verts[a] < f->n_verts[b]) {
+        uint t = a;
+        a = b;
+        b = t;
     }
+    f->block[b] = a;
+    f->n_verts[a] += f->n_verts[b];
+
+    return a;
 }
 
-// adds the vertices of name 'name_a' and 'name_b' to the graph 'g'
-// sets name_b as neighbor of name_a with weight 'weight', and vice-versa
-void add_graph_edge(grafo* g, char* name_a, char* name_b, uint weight)
+// returns the parent of node x of the forest (a vertex, or a block marked with BC_BLOCK),
+// NO_BLOCK if x is a root
+uint bc_parent(bc_forest* f, uint x)
 {
-    uint idx_a, idx_b;
-    add_graph_vert(g, name_a);
-    idx_b = (uint)add_graph_vert(g, name_b);
+    if (x & BC_BLOCK)
+        return f->top[x & ~BC_BLOCK];
 
-    // idx_a has to be searched because grapth might have been reallocated
-    // when adding name_b
-    idx_a = (uint)search_vert(g->v, g->v_num, name_a);
-
-    add_neighbor(g, idx_a, idx_b, weight);
-    add_neighbor(g, idx_b, idx_a, weight);
+    return (f->up[x] == NO_BLOCK) ? NO_BLOCK : (bc_find(f, f->up[x]) | BC_BLOCK);
 }
 
-// adds the string 'name' to the string list 'list'
-// reallocates list if necessary
-char** add_name(str_list* list, char* name)
+// marks node x as visited by the current search, returns 1 if it already was
+uint bc_visit(bc_forest* f, uint x)
 {
-    uint new_max;
-    if (list->size >= list->max) {
-        if (list->max == 0) {
-            list->str = NULL;
-            list->max = STARTING_CUT_LIST_NUM;
-            new_max = list->max;
-        } else
-            new_max = list->max * 2;
-
-        if (!(list->str = realloc(list->str, sizeof(char*) * new_max))) {
-            fprintf(stderr, "Erro add_name: nao foi possivel realocar lista de strings\n");
-            exit(EXIT_FAILURE);
-        }
+    uint* mark = (x & BC_BLOCK) ? &f->block_mark[x & ~BC_BLOCK] : &f->mark[x];
 
-        list->max = new_max;
-    }
-    (list->size)++;
-    (list->str)[list->size - 1] = name;
+    if (*mark == f->search)
+        return 1;
+    *mark = f->search;
 
-    return &(list->str[list->size - 1]);
+    return 0;
 }
 
-// concatanates names 'name1' and 'name2' in alphabetic order
-// separated by a space and returns the result
-char* create_edge_name(const char* name1, const char* name2)
+// makes vertex v the root of its tree, reversing the path from it to the old root
+// the vertices inside the path swap a parent block for a child one, so only the
+// counts of v and of the old root change
+void bc_evert(bc_forest* f, uint v)
 {
-    char* str;
+    uint x = v, below = NO_BLOCK;
 
-    if (name2[0] == '\0') {
-        if (!(str = malloc(sizeof(char) * strlen(name1))))
-            return NULL;
-        strcpy(str, name1);
-    } else {
-        size_t len = strlen(name1) + strlen(name2) + 2;
+    if (f->up[v] == NO_BLOCK)
+        return;
 
-        if (!(str = malloc(sizeof(char) * len)))
-            return NULL;
+    f->n_blocks[v]++;
+    while (f->up[x] != NO_BLOCK) {
+        uint b = bc_find(f, f->up[x]);
+        uint t = f->top[b];
+        f->up[x] = below;
+        f->top[b] = x;
+        below = b;
+        x = t;
+    }
+    f->up[x] = below;
+    f->n_blocks[x]--;
+}
 
-        if (strcmp(name1, name2) < 0) {
-            strcpy(str, name1);
-            strcat(str, " ");
-            strcat(str, name2);
-        } else {
-            strcpy(str, name2);
-            strcat(str, " ");
-            strcat(str, name1);
-        }
+// merges into *m the blocks on the path from vertex x up to node l, its ancestor
+// returns 1 if the path reaches l, a vertex, through a block
+uint bc_collapse_path(bc_forest* f, uint x, uint l, uint* m)
+{
+    while (x != l) {
+        uint b = bc_find(f, f->up[x]);
+        if ((b | BC_BLOCK) == l)
+            return 0;
+
+        uint t = f->top[b];
+        *m = (*m == NO_BLOCK) ? b : bc_union(f, *m, b);
+        if (t == l)
+            return 1;
+
+        // the child block of t on the path is now the block t is a child of
+        f->n_blocks[t]--;
+        x = t;
     }
 
-    return str;
+    return 0;
 }
 
-// calculate lowpoints of vertices in the tree of which 'r' is the root.
-// Adds names of the vertices that are cut vertices to the 'vertex_cut' list, and adds names of the
-// edges that are cut edges to the 'edge_cut' list
-void low_point(grafo* g, vertice* r, str_list* vertex_cut, str_list* edge_cut)
+// updates the block-cut forest of g with the edge {a, b}, still not in the union-find
+// an edge between two components hangs the smaller tree from a new bridge; an edge inside
+// a component merges the blocks on the path between a and b, found by walking up from
+// both ends at once, so the cost follows the length of the path and not the size of g
+void bc_insert(grafo* g, uint a, uint b)
 {
-    uint n_filhos = 0;
-    uint v_corte = 0;
-    r->estado = 1;
-
-    char* str;
-
-    // iterates through neighbors
-    neighbor* w = r->n_list;
-    while (w != NULL) {
-        if ((g->v[w->idx].estado == 1) && (g->v[w->idx].nivel < r->lowpoint)
-            && (&(g->v[w->idx]) != r->pai))
-            r->lowpoint = g->v[w->idx].nivel;
-        else if (g->v[w->idx].estado == 0) {
-            g->v[w->idx].pai = r;
-            g->v[w->idx].lowpoint = g->v[w->idx].nivel = r->nivel + 1;
-            low_point(g, &(g->v[w->idx]), vertex_cut, edge_cut);
-
-            if ((r->nivel <= g->v[w->idx].lowpoint) && (r->pai != NULL) && !v_corte) {
-                // adds vertex to vertex cut
-                str = create_edge_name(r->name, "");
-                add_name(vertex_cut, str);
-                v_corte++;
-            }
+    bc_forest* f = &g->bc;
+    uint pa, pb, l = NO_BLOCK, m = NO_BLOCK;
 
-            if (r->nivel < g->v[w->idx].lowpoint) {
-                // adds edge to edge cut
-                str = create_edge_name(r->name, g->v[w->idx].name);
-                add_name(edge_cut, str);
-            }
+    // the forest starts from the blocks of the last search, made again if they are gone
+    if (f->up == NULL) {
+        compute(g, CALCULA_BLOCOS);
+        bc_build(g);
+    }
 
-            // updates lowpoint if son reaches higher
-            if (g->v[w->idx].lowpoint < r->lowpoint)
-                r->lowpoint = g->v[w->idx].lowpoint;
+    if (a == b)
+        return;
+    f->stale = 1;
 
-            n_filhos++;
+    uint ra = dsu_find(&g->dsu, a, &pa);
+    uint rb = dsu_find(&g->dsu, b, &pb);
+
+    if (ra != rb) {
+        if (g->dsu.size[ra] < g->dsu.size[rb]) {
+            uint t = a;
+            a = b;
+            b = t;
         }
-        w = w->next;
+        bc_evert(f, b);
+        f->up[b] = bc_new_block(f, a);
+        f->n_verts[f->up[b]] = 1;
+        f->n_blocks[a]++;
+        return;
     }
 
-    if ((r->pai == NULL) && (n_filhos > 1)) {
-        // adds vertex to vertex cut
-        str = create_edge_name(r->name, "");
-        add_name(vertex_cut, str);
+    // the first node reached by one side that the other already went through is
+    // the lowest common ancestor of a and b
+    f->search++;
+    bc_visit(f, a);
+    bc_visit(f, b);
+    for (uint x = a, y = b; l == NO_BLOCK;) {
+        if ((x != NO_BLOCK) && ((x = bc_parent(f, x)) != NO_BLOCK) && bc_visit(f, x))
+            l = x;
+        else if ((y != NO_BLOCK) && ((y = bc_parent(f, y)) != NO_BLOCK) && bc_visit(f, y))
+            l = y;
     }
 
-    r->estado = 2;
+    uint hits = bc_collapse_path(f, a, l, &m) + bc_collapse_path(f, b, l, &m);
+    if (m == NO_BLOCK)
+        return;
+
+    if (l & BC_BLOCK) {
+        uint top = f->top[l & ~BC_BLOCK];
+        f->top[bc_union(f, l & ~BC_BLOCK, m)] = top;
+    } else {
+        // the blocks of both sides below l are now a single child of l
+        f->top[m] = l;
+        f->n_blocks[l] -= hits - 1;
+    }
 }
 
-// identifies and saves vertex cut and edge cut of the graph
-void set_cut(grafo* g)
+// sets the lists of cut vertices and bridges of g from its block-cut forest
+void bc_cut_lists(grafo* g)
 {
-    // empties vertex_cut list
-    if (g->vertex_cut.str != NULL) {
-        for (uint i = 0; i < g->vertex_cut.size; i++)
-            free(g->vertex_cut.str[i]);
-        free(g->vertex_cut.str);
-        g->vertex_cut.str = NULL;
-        g->vertex_cut.size = g->vertex_cut.max = 0;
-    }
+    bc_forest* f = &g->bc;
+    STATS_START(start);
 
-    // empties edge_cut list
-    if (g->edge_cut.str != NULL) {
-        for (uint i = 0; i < g->edge_cut.size; i++)
-            free(g->edge_cut.str[i]);
-        free(g->edge_cut.str);
-        g->edge_cut.str = NULL;
-        g->edge_cut.size = g->edge_cut.max = 0;
-    }
+    g->vertex_cut.size = 0;
+    g->edge_cut.size = 0;
 
-    set_states(g->v, g->v_num, 0);
+    for (uint v = 0; v < f->n_v; v++) {
+        uint b = (f->up[v] == NO_BLOCK) ? NO_BLOCK : bc_find(f, f->up[v]);
 
-    for (uint i = 0; i < g->v_num; i++) {
-        if (g->v[i].estado == 0) {
-            g->v[i].lowpoint = g->v[i].nivel = 0;
-            g->v[i].pai = NULL;
-            low_point(g, &g->v[i], &g->vertex_cut, &g->edge_cut);
+        if (f->n_blocks[v] + (b != NO_BLOCK) > 1)
+            add_uint(&g->vertex_cut, v);
+
+        if ((b != NO_BLOCK) && (f->n_verts[b] == 1)) {
+            add_uint(&g->edge_cut, f->top[b]);
+            add_uint(&g->edge_cut, v);
         }
     }
-}
-
-// auxiliary function to compare names
-int comp_name(const void* a, const void* b) { return strcmp(*(char* const*)a, *(char* const*)b); }
 
-// auxiliary function to compare numbers read from strings
-int comp_number(const void* a, const void* b)
-{
-    int n1 = atoi(*(char* const*)a);
-    int n2 = atoi(*(char* const*)b);
-    if (n1 < n2)
-        return -1;
-    else if (n1 == n2)
-        return 0;
-    return 1;
+    f->stale = 0;
+    STATS_STOP(g->stats.cortes, start);
 }
 
-// creates a string concatenating strings of given list 'str' of size 'size' sorted
-// using given function 'func'
-char* create_str_from_str_list(char** str, uint size, int (*func)(const void* a, const void* b))
+// sets the offsets of the sections of a snapshot from the counts in its header, and the
+// size of the file. Each section starts at a multiple of 8 bytes
+void snapshot_layout(snapshot_header* h)
 {
-    char* string;
-    if (size == 0) {
-        if (!(string = malloc(sizeof(char) * 1)))
-            return NULL;
-        string[0] = '\0';
-        return string;
+    unsigned long long len[SNAP_SECTIONS];
+    unsigned long long pos = sizeof(snapshot_header);
+    uint comp = (h->valid & CALCULA_COMPONENTES) != 0;
+
+    len[SNAP_NAME] = h->name_len + 1;
+    len[SNAP_NAME_OFF] = sizeof(uint) * (unsigned long long)h->v_num;
+    len[SNAP_SLOTS] = sizeof(name_slot) * (unsigned long long)h->name_capacity;
+    len[SNAP_ADJ_OFF] = sizeof(uint) * ((unsigned long long)h->v_num + 1);
+    len[SNAP_ADJ] = sizeof(uint) * (unsigned long long)h->n_adj;
+    len[SNAP_ADJ_W] = len[SNAP_ADJ];
+    len[SNAP_COMPONENT] = comp ? sizeof(uint) * (unsigned long long)h->v_num : 0;
+    len[SNAP_COLOR] = comp ? h->v_num : 0;
+    len[SNAP_ODD_CYCLE] = sizeof(uint) * (unsigned long long)h->odd_len;
+    len[SNAP_VERTEX_CUT] = sizeof(uint) * (unsigned long long)h->n_vertex_cut;
+    len[SNAP_EDGE_CUT] = sizeof(uint) * (unsigned long long)h->n_edge_cut;
+    len[SNAP_DIAMETROS] = sizeof(uint) * (unsigned long long)h->n_diametros;
+    len[SNAP_STRINGS] = h->strings_len;
+
+    for (uint i = 0; i < SNAP_SECTIONS; i++) {
+        h->off[i] = pos;
+        pos += (len[i] + 7) & ~7ull;
     }
+    h->size = pos;
+}
 
-    qsort(str, size, sizeof(char*), func);
-
-    size_t total_len = 0;
+// returns 1 if the 'size' bytes at h are a snapshot this version can use in place
+// the layout is computed again from the counts in the header, which bounds every section
+// by the size of the file, and the checksum covers the whole file
+uint snapshot_check(const snapshot_header* h, size_t size)
+{
+    snapshot_header layout = *h;
 
-    // calcluates total size of output string
-    for (uint i = 0; i < size; i++) {
-        total_len += strlen(str[i]);
-        total_len++;
-    }
+    if (memcmp(h->magic, SNAPSHOT_MAGIC, sizeof(h->magic)) || (h->version != SNAPSHOT_VERSION)
+        || (h->n_adj > 0 && h->v_num == 0) || (h->name_capacity <= h->v_num)
+        || (h->name_capacity & (h->name_capacity - 1)) || (h->strings_len > UINT_MAX))
+        return 0;
 
-    // allocate string
-    if (!(string = malloc(sizeof(char) * total_len)))
-        return NULL;
+    snapshot_layout(&layout);
+    if ((layout.size != size) || (layout.size != h->size)
+        || memcmp(layout.off, h->off, sizeof(layout.off)))
+        return 0;
 
-    string[0] = '\0';
-    // concatanates name of all vertices to the output string
-    uint i;
-    for (i = 0; i < size - 1; i++) {
-        strcat(string, str[i]);
-        strcat(string, " ");
+    const char* data = (const char*)h;
+    unsigned long long sum = SNAPSHOT_SEED;
+    for (size_t pos = sizeof(snapshot_header); pos < size; pos += 8) {
+        unsigned long long x;
+        memcpy(&x, data + pos, 8);
+        sum = snapshot_mix(sum, x);
     }
-    strcat(string, str[i]);
+    if (snapshot_header_sum(h, sum) != h->checksum)
+        return 0;
 
-    return string;
+    // the strings are terminated inside their section
+    return (h->strings_len == 0) || (data[h->off[SNAP_STRINGS] + h->strings_len - 1] == '\0');
 }
 
-// sets distance from vertex 'r' of every vertex in the same component as r
-void dijkstra_max_dist(grafo* g, vertice* r)
+// returns 1 if every index stored in the snapshot mapped at 'map' is in range and the
+// adjacency rows are sorted, so that a file which passes the checksum but was not
+// written by salva_grafo_binario cannot make the graph read or write out of bounds
+// the diameters are plain values and need no check
+uint snapshot_indices(const snapshot_header* h, const char* map)
 {
-    heap_t* h = heap_create();
-    // copia vertices do componente de r para lista de prioridades
-    for (uint i = 0; i < g->v_num; i++)
-        if (g->v[i].componente == r->componente) {
-            g->v[i].dist = UINT_MAX;
-            if (r == &(g->v[i]))
-                g->v[i].dist = 0;
-            heap_append_vertex(h, &(g->v[i]));
-        }
+    const uint* name_off = (const uint*)(map + h->off[SNAP_NAME_OFF]);
+    const name_slot* slots = (const name_slot*)(map + h->off[SNAP_SLOTS]);
+    const uint* adj_off = (const uint*)(map + h->off[SNAP_ADJ_OFF]);
+    const uint* adj = (const uint*)(map + h->off[SNAP_ADJ]);
+    const uint* comp = (const uint*)(map + h->off[SNAP_COMPONENT]);
+    const uint* odd_cycle = (const uint*)(map + h->off[SNAP_ODD_CYCLE]);
+    const uint* cut = (const uint*)(map + h->off[SNAP_VERTEX_CUT]);
+    const uint* bridges = (const uint*)(map + h->off[SNAP_EDGE_CUT]);
+    uint used = 0;
+
+    if (h->n_edge_cut & 1)
+        return 0;
+    for (uint i = 0; i < h->v_num; i++)
+        if (name_off[i] >= h->strings_len)
+            return 0;
 
-    vertice* v;
-    neighbor* w;
-
-    while (h->size != 0) {
-        v = heap_pop_vertex(h);
-        w = v->n_list;
-        while (w != NULL) {
-            if ((v->dist + w->weight) < g->v[w->idx].dist)
-                g->v[w->idx].dist = v->dist + w->weight;
-            heapify_vertex_up(h, &(g->v[w->idx]));
-            w = w->next;
-        }
+    // every vertex has one slot, and the table keeps empty slots to end the probes
+    for (uint i = 0; i < h->name_capacity; i++) {
+        if (slots[i].idx == EMPTY_SLOT)
+            continue;
+        if ((slots[i].idx >= h->v_num) || (++used > h->v_num))
+            return 0;
     }
-    heap_free(h);
-}
-
-// calculates diameters of every component and saves them to the graph
-void set_diameters(grafo* g)
-{
-    char buffer[50];
-    char* diam_str = NULL;
-    queue_t* queue = NULL;
-    vertice* r;
-    uint diametro;
-    uint max_dist;
-    int len;
-
-    if (g->n_componentes == 0)
-        g->n_componentes = set_components(g);
-
-    set_states(g->v, g->v_num, 0);
+    if (used != h->v_num)
+        return 0;
 
-    for (uint c = 1; c <= g->n_componentes; c++) {
-        diametro = 0;
+    if ((adj_off[0] != 0) || (adj_off[h->v_num] != h->n_adj))
+        return 0;
+    for (uint v = 0; v < h->v_num; v++) {
+        if (adj_off[v] > adj_off[v + 1])
+            return 0;
+        for (uint k = adj_off[v]; k < adj_off[v + 1]; k++)
+            if ((adj[k] >= h->v_num) || ((k > adj_off[v]) && (adj[k] <= adj[k - 1])))
+                return 0;
+    }
 
-        for (uint i = 0; i < g->v_num; i++) {
-            if (g->v[i].componente == c)
-                // cria lista com vertices do componente atual
-                queue_append(&queue, &(g->v[i]));
-        }
+    if (h->valid & CALCULA_COMPONENTES) {
+        if ((h->n_componentes > h->v_num) || (h->bipartite > 1))
+            return 0;
+        for (uint i = 0; i < h->v_num; i++)
+            if ((comp[i] == 0) || (comp[i] > h->n_componentes))
+                return 0;
+        for (uint i = 0; i < h->odd_len; i++)
+            if (odd_cycle[i] >= h->v_num)
+                return 0;
+    }
 
-        while ((r = queue_pop(&queue))) {
-            max_dist = 0;
+    for (uint i = 0; i < h->n_vertex_cut; i++)
+        if (cut[i] >= h->v_num)
+            return 0;
+    for (uint i = 0; i < h->n_edge_cut; i++)
+        if (bridges[i] >= h->v_num)
+            return 0;
 
-            // seta distancias até r
-            dijkstra_max_dist(g, r);
+    return 1;
+}
 
-            // busca maior distancia
-            for (uint i = 0; i < g->v_num; i++)
-                if (g->v[i].componente == c)
-                    if (max_dist < g->v[i].dist)
-                        max_dist = g->v[i].dist;
+// builds the graph of the snapshot mapped at 'map'
+// the name table and the adjacency arrays are used in place; the arrays of vertices,
+// which change with the graph, are allocated, with the names pointing into the mapping
+grafo* load_snapshot(char* map, size_t size)
+{
+    const snapshot_header* h = (const snapshot_header*)map;
+    char* strings = map + h->off[SNAP_STRINGS];
+    const uint* name_off = (const uint*)(map + h->off[SNAP_NAME_OFF]);
+    const uint* comp = (const uint*)(map + h->off[SNAP_COMPONENT]);
+    grafo* g;
 
-            // atualiza diametro do componente
-            if (max_dist > diametro)
-                diametro = max_dist;
-        }
+    if (!snapshot_indices(h, map) || !(g = create_graph(map + h->off[SNAP_NAME], h->name_len)))
+        return NULL;
 
-        // transforma diametro em string
-        len = snprintf(buffer, 50, "%u", diametro);
-        if (len < 0) {
-            fprintf(
-                stderr, "Erro set_diameters: nao foi possivel converter diametro para string\n");
+    if ((h->v_num > g->max_v_num) && !(g->v_name = realloc(g->v_name, sizeof(char*) * h->v_num))) {
+        fprintf(stderr, "Erro load_snapshot: nao foi possivel alocar lista de vertices\n");
+        exit(EXIT_FAILURE);
+    }
+    if (h->v_num > g->max_v_num)
+        g->max_v_num = h->v_num;
+
+    for (uint i = 0; i < h->v_num; i++)
+        g->v_name[i] = strings + name_off[i];
+    g->v_num = h->v_num;
+
+    free(g->names.slots);
+    g->names.slots = (name_slot*)(void*)(map + h->off[SNAP_SLOTS]);
+    g->names.capacity = h->name_capacity;
+    g->names.used = h->v_num;
+    g->adj_off = (uint*)(void*)(map + h->off[SNAP_ADJ_OFF]);
+    g->adj = (uint*)(void*)(map + h->off[SNAP_ADJ]);
+    g->adj_w = (uint*)(void*)(map + h->off[SNAP_ADJ_W]);
+    g->adj_v_num = h->v_num;
+    g->e_num = h->e_num;
+    g->snapshot = map;
+    g->snapshot_len = size;
+    g->shared = 1;
+    set_kernel(g, h->min_w, h->max_w);
+
+    if (h->valid & CALCULA_COMPONENTES) {
+        if (!(g->component = malloc(sizeof(uint) * (h->v_num + 1)))
+            || !(g->color = malloc(h->v_num + 1))
+            || !(g->odd_cycle = malloc(sizeof(uint) * (h->odd_len + 1)))) {
+            fprintf(stderr, "Erro load_snapshot: nao foi possivel alocar coloracao\n");
             exit(EXIT_FAILURE);
         }
+        memcpy(g->component, comp, sizeof(uint) * h->v_num);
+        memcpy(g->color, map + h->off[SNAP_COLOR], h->v_num);
+        memcpy(g->odd_cycle, map + h->off[SNAP_ODD_CYCLE], sizeof(uint) * h->odd_len);
+        g->n_componentes = h->n_componentes;
+        g->bipartite = h->bipartite;
+        g->odd_len = h->odd_len;
+    }
 
-        // copia string do diametro num array dinamico
-        if (!(diam_str = malloc(sizeof(char) * (uint)len + 1))) {
-            fprintf(stderr, "Erro set_diameters: nao foi possivel alocar string do diametro\n");
-            exit(EXIT_FAILURE);
-        }
-        strcpy(diam_str, buffer);
+    snapshot_items(&g->vertex_cut, map + h->off[SNAP_VERTEX_CUT], h->n_vertex_cut);
+    snapshot_items(&g->edge_cut, map + h->off[SNAP_EDGE_CUT], h->n_edge_cut);
+    snapshot_items(&g->diametros, map + h->off[SNAP_DIAMETROS], h->n_diametros);
 
-        // armazena informacao do diametro
-        add_name(&g->diametros, diam_str);
-    }
+    g->valid = h->valid;
+
+    return g;
 }
 
-// appends a new element to the queue
-void queue_append(queue_t** queue, void* elem)
+// copies the name table and the adjacency arrays of g out of its snapshot, before they
+// are changed
+void detach_snapshot(grafo* g)
 {
-    if (!queue) {
-        fprintf(stderr, "Erro queue_append: fila nao existe\n");
-        exit(EXIT_FAILURE);
-    }
+    name_slot* slots;
+    uint *off, *adj, *adj_w;
 
-    if (!elem) {
-        fprintf(stderr, "Erro queue_append: elemento nao existe\n");
-        exit(EXIT_FAILURE);
-    }
+    if (!g->shared)
+        return;
 
-    queue_t* node;
-    if (!(node = malloc(sizeof(queue_t)))) {
-        fprintf(stderr, "Erro queue_append: nao foi possivel alocar nodo\n");
+    uint n_adj = g->adj_off[g->adj_v_num];
+
+    if (!(slots = malloc(sizeof(name_slot) * g->names.capacity))
+        || !(off = malloc(sizeof(uint) * (g->adj_v_num + 1)))
+        || !(adj = malloc(sizeof(uint) * n_adj + 1))
+        || !(adj_w = malloc(sizeof(uint) * n_adj + 1))) {
+        fprintf(stderr, "Erro detach_snapshot: nao foi possivel copiar o grafo\n");
         exit(EXIT_FAILURE);
     }
+    memcpy(slots, g->names.slots, sizeof(name_slot) * g->names.capacity);
+    memcpy(off, g->adj_off, sizeof(uint) * (g->adj_v_num + 1));
+    memcpy(adj, g->adj, sizeof(uint) * n_adj);
+    memcpy(adj_w, g->adj_w, sizeof(uint) * n_adj);
+
+    g->names.slots = slots;
+    g->adj_off = off;
+    g->adj = adj;
+    g->adj_w = adj_w;
+    g->shared = 0;
+}
 
-    if (!(*queue)) {
-        // caso a lista esteja vazia, adiciona o elemento
-        node->elem = elem;
-        node->next = node->prev = node;
-        (*queue) = node;
-        return;
+// adds the header h, with its checksum zeroed, to the checksum 'sum' of the sections
+unsigned long long snapshot_header_sum(const snapshot_header* h, unsigned long long sum)
+{
+    snapshot_header copy = *h;
+    unsigned long long x;
+
+    copy.checksum = 0;
+    for (size_t pos = 0; pos < sizeof(snapshot_header); pos += 8) {
+        memcpy(&x, (const char*)&copy + pos, 8);
+        sum = snapshot_mix(sum, x);
     }
 
-    queue_t* prev_node = (*queue)->prev;
+    return sum;
+}
 
-    // insere elemento no final da fila
-    node->elem = elem;
-    node->prev = prev_node;
-    node->next = (*queue);
+// mixes the 8 bytes x into the checksum h
+unsigned long long snapshot_mix(unsigned long long h, unsigned long long x)
+{
+    h = (h ^ x) * 0x9e3779b97f4a7c15ull;
 
-    (*queue)->prev = node;
-    prev_node->next = node;
+    return h ^ (h >> 32);
 }
 
-// pops firs element of the queue and returns a pointer to its content
-void* queue_pop(queue_t** queue)
+// writes 'len' bytes of data to the snapshot of w, adding them to its checksum 8 at a time
+void snapshot_write(snapshot_writer* w, const void* data, size_t len)
 {
-    void* elem;
-
-    if (*queue == NULL)
-        return NULL;
+    const unsigned char* p = data;
+
+    if ((len > 0) && (fwrite(data, 1, len, w->f) != len))
+        w->ok = 0;
+
+    while (len > 0) {
+        if ((w->n_bytes == 0) && (len >= 8)) {
+            unsigned long long x;
+            memcpy(&x, p, 8);
+            w->checksum = snapshot_mix(w->checksum, x);
+            p += 8;
+            len -= 8;
+            continue;
+        }
 
-    elem = (*queue)->elem;
-    if ((*queue)->next == *queue) {
-        free(*queue);
-        *queue = NULL;
-    } else {
-        (*queue)->next->prev = (*queue)->prev;
-        (*queue)->prev->next = (*queue)->next;
-        queue_t* aux = *queue;
-        *queue = (*queue)->next;
-        free(aux);
+        w->word[w->n_bytes++] = *p++;
+        len--;
+        if (w->n_bytes == 8) {
+            unsigned long long x;
+            memcpy(&x, w->word, 8);
+            w->checksum = snapshot_mix(w->checksum, x);
+            w->n_bytes = 0;
+        }
     }
-
-    return elem;
 }
 
-// destroys queue and sets its value to NULL
-void destroy_queue(queue_t** queue)
+// writes zeros up to the next multiple of 8 bytes
+void snapshot_pad(snapshot_writer* w)
 {
-    if (*queue == NULL)
-        return;
-
-    queue_t *node, *aux;
-    node = *queue;
+    static const unsigned char zeros[8];
 
-    while (node->next != node) {
-        node->next->prev = node->prev;
-        node->prev->next = node->next;
+    if (w->n_bytes > 0)
+        snapshot_write(w, zeros, 8 - w->n_bytes);
+}
 
-        aux = node->next;
-        free(node);
-        node = aux;
+// copies the 'n' entries at 'data', saved in output order, to 'list'
+// the list is copied and not used in place, since it changes with the graph
+void snapshot_items(uint_list* list, const char* data, uint n)
+{
+    if (n > list->max) {
+        if (!(list->v = realloc(list->v, sizeof(uint) * n))) {
+            fprintf(stderr, "Erro snapshot_items: nao foi possivel alocar lista de resultados\n");
+            exit(EXIT_FAILURE);
+        }
+        list->max = n;
     }
-
-    free(node);
-    *queue = NULL;
+    if (n > 0)
+        memcpy(list->v, data, sizeof(uint) * n);
+    list->size = n;
+    list->sorted = 1;
 }
 
-// Creates a heap with initial capacity
-heap_t* heap_create(void)
+#ifdef GRAFO_STATS
+// returns the time in seconds from a fixed point, for the phases of grafo_stats
+double stats_now(void)
 {
-    heap_t* h;
+    struct timespec ts;
 
-    if (!(h = malloc(sizeof(heap_t)))) {
-        fprintf(stderr, "Erro heap_create: nao foi possivel alocar heap\n");
-        exit(EXIT_FAILURE);
-    }
+    clock_gettime(CLOCK_MONOTONIC, &ts);
 
-    if (!(h->items = malloc(sizeof(vertice*) * STARTING_VERT_NUM))) {
-        fprintf(stderr, "Erro heap_create: nao foi possivel alocar itens da heap\n");
-        exit(EXIT_FAILURE);
-    }
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
 
-    h->size = 0;
-    h->capacity = STARTING_VERT_NUM;
+// raises the peak of g to the bytes of its structures plus 'extra' bytes of working
+// memory of the phase running. The arrays are counted by their capacity
+void stats_peak(grafo* g, size_t extra)
+{
+    size_t bytes = extra + g->mem.used + sizeof(char*) * g->max_v_num
+        + sizeof(edge) * g->staged.max + sizeof(uint) * g->dsu.max * 4;
+
+    // the arrays of a snapshot are shared with other processes
+    if (!g->shared) {
+        bytes += sizeof(name_slot) * g->names.capacity;
+        if (g->adj_off != NULL)
+            bytes += sizeof(uint)
+                * ((size_t)g->adj_v_num + 1 + 2 * (size_t)g->adj_off[g->adj_v_num]);
+    }
 
-    return h;
+    if (bytes > g->stats.pico_bytes)
+        g->stats.pico_bytes = bytes;
 }
 
-// detroys heap
-void heap_free(heap_t* h)
+// adds the counters of the queue h to those of g
+void stats_heap(grafo* g, const heap_t* h)
 {
-    free(h->items);
-    free(h);
+    g->stats.insercoes += h->pushes;
+    g->stats.remocoes += h->pops;
+    g->stats.reducoes += h->decreases;
+    g->stats.arestas_relaxadas += h->relaxed;
+    g->stats.filas_alocadas++;
 }
 
-// swaps two vertices in an array
-void swap(vertice** a, vertice** b)
+// returns the bytes allocated by the 'n' threads parsing the pieces of the input
+size_t stats_chunks(const chunk_parse* chunks, uint n)
 {
-    vertice* temp = *a;
-    *a = *b;
-    *b = temp;
+    size_t bytes = 0;
+
+    for (uint t = 0; t < n; t++)
+        bytes += (sizeof(token) + 2 * sizeof(uint)) * chunks[t].max_names
+            + sizeof(name_slot) * chunks[t].capacity + sizeof(edge) * chunks[t].max_edges;
+
+    return bytes;
 }
 
-// updates heap upwards from idx
-void heapify_up(heap_t* h, uint idx)
+// writes the counters of g to stderr if the environment variable GRAFO_STATS is set
+void stats_dump(grafo* g)
 {
-    while (idx > 0) {
-        uint parent = (idx - 1) / 2;
-        if (h->items[parent]->dist <= h->items[idx]->dist)
-            break;
-        swap(&h->items[parent], &h->items[idx]);
-        idx = parent;
-    }
+    const char* env = getenv("GRAFO_STATS");
+    const grafo_stats* s = &g->stats;
+
+    if (!env || (env[0] == '\0') || !strcmp(env, "0"))
+        return;
+
+    fprintf(stderr,
+        "grafo_stats %s: leitura %.6f s, componentes %.6f s, cortes %.6f s, diametros %.6f s, "
+        "linhas %llu, buscas_nome %llu, arestas_relaxadas %llu, insercoes %llu, remocoes %llu, "
+        "reducoes %llu, filas_alocadas %llu, pico_bytes %zu\n",
+        g->name, s->leitura, s->componentes, s->cortes, s->diametros, s->linhas, s->buscas_nome,
+        s->arestas_relaxadas, s->insercoes, s->remocoes, s->reducoes, s->filas_alocadas,
+        s->pico_bytes);
 }
+#endif
 
-// updates heap upwards from v
-void heapify_vertex_up(heap_t* h, vertice* v)
+// allocates 'size' bytes from the arena 'a', aligned to ARENA_ALIGN
+void* arena_alloc(arena* a, size_t size)
 {
-    for (uint i = 0; i < h->size; i++) {
-        if (h->items[i] == v) {
-            heapify_up(h, i);
-            break;
-        }
-    }
+    return arena_alloc_bytes(a, size, ARENA_ALIGN);
 }
 
-// updates heap downwards from idx
-void heapify_down(heap_t* h, uint idx)
+// allocates 'size' bytes from the arena 'a', aligned to 'align' (a power of two at most
+// ARENA_ALIGN); strings take alignment 1, so short names are not padded to ARENA_ALIGN
+// requests that do not fit in the current chunk start a new one, and requests bigger than
+// a quarter of a chunk get a chunk of their own
+void* arena_alloc_bytes(arena* a, size_t size, size_t align)
 {
-    while (1) {
-        uint left = 2 * idx + 1;
-        uint right = 2 * idx + 2;
-        uint smallest = idx;
+    arena_chunk* chunk = a->head;
+    size_t start = 0;
+    void* ptr;
 
-        if (left < h->size && h->items[left]->dist < h->items[smallest]->dist)
-            smallest = left;
-        if (right < h->size && h->items[right]->dist < h->items[smallest]->dist)
-            smallest = right;
+    if (chunk)
+        start = (chunk->used + align - 1) & ~(align - 1);
 
-        if (smallest == idx)
-            break;
+    if (!chunk || (start > chunk->size) || (chunk->size - start < size)) {
+        size_t chunk_size = (size > ARENA_CHUNK_SIZE / 4) ? size : ARENA_CHUNK_SIZE;
 
-        swap(&h->items[idx], &h->items[smallest]);
-        idx = smallest;
+        // the chunk header is placed right before its (aligned) data
+        size_t header = (sizeof(arena_chunk) + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+        if (!(chunk = malloc(header + chunk_size))) {
+            fprintf(stderr, "Erro arena_alloc: nao foi possivel alocar bloco da arena\n");
+            exit(EXIT_FAILURE);
+        }
+        chunk->data = (char*)chunk + header;
+        chunk->size = chunk_size;
+        chunk->used = 0;
+        start = 0;
+
+        if (a->head && (chunk_size != ARENA_CHUNK_SIZE)) {
+            // keeps the current chunk in front, as it may still have room for small requests
+            chunk->next = a->head->next;
+            a->head->next = chunk;
+        } else {
+            chunk->next = a->head;
+            a->head = chunk;
+        }
     }
+
+    ptr = chunk->data + start;
+    a->used += start + size - chunk->used;
+    chunk->used = start + size;
+
+    return ptr;
 }
 
-// appends vertex to heap
-void heap_append_vertex(heap_t* h, vertice* v)
+// copies the first 'len' characters of 'str' to the arena 'a' as a null terminated string
+char* arena_strdup(arena* a, const char* str, size_t len)
 {
-    if (h->size >= h->capacity) {
-        uint new_capacity = h->capacity * 2;
-        if (!(h->items = realloc(h->items, sizeof(vertice*) * new_capacity))) {
-            fprintf(stderr, "Erro heap_append_vertex: nao foi possivel realocar itens da heap\n");
-            exit(EXIT_FAILURE);
-        }
+    char* copy = arena_alloc_bytes(a, sizeof(char) * len + 1, 1);
 
-        h->capacity = new_capacity;
-    }
+    memcpy(copy, str, len);
+    copy[len] = '\0';
 
-    h->items[h->size] = v;
-    heapify_up(h, h->size);
-    h->size++;
+    return copy;
 }
 
-// pops min vertex from heap
-vertice* heap_pop_vertex(heap_t* h)
+// releases every chunk of the arena 'a'
+void arena_free(arena* a)
 {
-    if (h->size == 0) {
-        fprintf(stderr, "Erro heap_pop_vertex: heap vazia\n");
-        exit(EXIT_FAILURE);
+    arena_chunk* chunk;
+
+    while (a->head != NULL) {
+        chunk = a->head->next;
+        free(a->head);
+        a->head = chunk;
     }
-    vertice* min = h->items[0];
-    h->items[0] = h->items[h->size - 1];
-    h->size--;
-    heapify_down(h, 0);
-    return min;
+
+    a->used = 0;
 }
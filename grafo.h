@@ -49,6 +49,102 @@ três
 
 grafo* le_grafo(FILE* f);
 
+//------------------------------------------------------------------------------
+// resultados que podem ser calculados de antemão por le_grafo_opcoes() e pre_calcula()
+//
+// os resultados de n_componentes(), bipartido(), vertices_corte(), arestas_corte() e
+// diametros() são calculados na primeira vez em que são pedidos e guardados em g;
+// as opções abaixo, combinadas com |, permitem pagar esse custo na leitura
+
+#define CALCULA_COMPONENTES 1u
+#define CALCULA_BIPARTIDO 2u
+#define CALCULA_CORTES 4u
+#define CALCULA_DIAMETROS 8u
+#define CALCULA_TUDO 15u
+
+//------------------------------------------------------------------------------
+// lê um grafo de f como le_grafo() e o devolve, calculando de antemão os
+// resultados indicados em 'opcoes'
+
+grafo* le_grafo_opcoes(FILE* f, unsigned int opcoes);
+
+//------------------------------------------------------------------------------
+// calcula os resultados de g indicados em 'opcoes' que ainda não foram calculados
+
+void pre_calcula(grafo* g, unsigned int opcoes);
+
+//------------------------------------------------------------------------------
+// lê um grafo do arquivo de nome 'caminho' e o devolve
+//
+// o formato do arquivo é o mesmo de le_grafo() e o grafo devolvido é idêntico
+// ao que le_grafo() devolveria para o mesmo arquivo; o arquivo é mapeado em
+// memória e lido diretamente do mapeamento, sem cópias intermediárias
+//
+// devolve NULL se o arquivo não puder ser lido
+
+grafo* le_grafo_arquivo(const char* caminho);
+
+//------------------------------------------------------------------------------
+// como le_grafo_arquivo(), mas divide as linhas do arquivo entre 'n_threads'
+// threads, que as leem em paralelo; se 'n_threads' é 0, usa uma thread por
+// processador disponível
+//
+// o grafo devolvido é idêntico ao de le_grafo_arquivo(), inclusive nos índices
+// dos vértices; arquivos pequenos são lidos por uma thread só
+
+grafo* le_grafo_arquivo_paralelo(const char* caminho, unsigned int n_threads);
+
+//------------------------------------------------------------------------------
+// grava g no arquivo de nome 'caminho' num formato binário que
+// carrega_grafo_binario() usa sem reprocessar nada: a tabela de nomes, a lista
+// de adjacência e os resultados já calculados (componentes, bipartição, cortes e
+// diâmetros), com um cabeçalho que guarda a versão do formato e uma soma de
+// verificação
+//
+// o arquivo é escrito ao lado, num arquivo temporário de nome único no mesmo
+// diretório, e renomeado sobre 'caminho', então processos que usam um arquivo
+// anterior com o mesmo nome não são afetados, nem gravações simultâneas
+//
+// devolve 1 em caso de sucesso e 0 em caso de erro
+
+unsigned int salva_grafo_binario(grafo* g, const char* caminho);
+
+//------------------------------------------------------------------------------
+// lê um grafo gravado por salva_grafo_binario() no arquivo de nome 'caminho' e
+// o devolve, com os resultados que estavam calculados quando ele foi gravado
+//
+// o arquivo é mapeado em memória só para leitura e usado no lugar: a tabela de
+// nomes e a lista de adjacência não são copiadas, e vários processos que
+// carregam o mesmo arquivo compartilham as mesmas páginas. Só os vértices são
+// alocados; o grafo só é copiado do arquivo se for alterado
+//
+// devolve NULL se o arquivo não puder ser lido, for de outra versão ou estiver
+// corrompido: além da soma de verificação, todos os índices de vértices do
+// arquivo são conferidos antes de usados
+
+grafo* carrega_grafo_binario(const char* caminho);
+
+//------------------------------------------------------------------------------
+// acrescenta a g o vértice de nome 'nome', se ele ainda não existe, e devolve o
+// seu índice
+
+long long int adiciona_vertice(grafo* g, const char* nome);
+
+//------------------------------------------------------------------------------
+// acrescenta a g a aresta {nome1, nome2} com peso 'peso', acrescentando também
+// os vértices que ainda não existem; se a aresta já existe, nada muda
+//
+// devolve 1 em caso de sucesso e 0 em caso de erro
+//
+// depois da primeira inserção, n_componentes() e bipartido() são mantidos por uma
+// estrutura union-find (com a paridade de cada vértice) em tempo quase constante
+// por inserção; se os cortes de g já foram calculados, vertices_corte() e
+// arestas_corte() passam a ser mantidos numa floresta de blocos e cortes, e cada
+// inserção custa o comprimento do caminho entre os vértices da aresta nessa
+// floresta; os demais resultados são recalculados quando pedidos
+
+unsigned int adiciona_aresta(grafo* g, const char* nome1, const char* nome2, unsigned int peso);
+
 //------------------------------------------------------------------------------
 // desaloca toda a estrutura de dados alocada em g
 //
@@ -56,21 +152,189 @@ grafo* le_grafo(FILE* f);
 
 unsigned int destroi_grafo(grafo* g);
 
+//------------------------------------------------------------------------------
+// define o número de threads usadas nos cálculos de g; se 'n_threads' é 0 (o
+// padrão), usa uma thread por processador disponível
+//
+// com 'n_threads' maior que 1, n_componentes() e os diâmetros rotulam os
+// componentes de grafos grandes com uma union-find compartilhada pelas threads, sem
+// a busca em largura que também dá a bipartição; bipartido() e biparticao() fazem
+// essa busca quando chamadas. Com 0 ou 1 os componentes vêm sempre da busca em
+// largura
+//
+// os resultados não dependem do número de threads
+
+void define_n_threads(grafo* g, unsigned int n_threads);
+
+//------------------------------------------------------------------------------
+// algoritmos para o cálculo dos diâmetros, escolhidos por define_modo_diametro()
+//
+// DIAMETRO_LIMITES (o padrão) mantém limites inferiores e superiores para a
+// excentricidade de cada vértice e só executa Dijkstra a partir dos vértices que
+// ainda podem aumentar o diâmetro; em grafos reais costuma bastar um punhado de
+// execuções por componente
+//
+// DIAMETRO_TODAS_ORIGENS executa Dijkstra a partir de todos os vértices, dividindo
+// as execuções entre as threads de g
+//
+// os dois devolvem os mesmos diâmetros
+
+#define DIAMETRO_LIMITES 0u
+#define DIAMETRO_TODAS_ORIGENS 1u
+
+void define_modo_diametro(grafo* g, unsigned int modo);
+
+//------------------------------------------------------------------------------
+// algoritmos de caminhos mínimos usados nos cálculos de diâmetros, escolhidos por
+// define_algoritmo_caminhos()
+//
+// CAMINHOS_AUTOMATICO (o padrão) escolhe pelos pesos das arestas de g: busca em
+// largura se todos os pesos são 1, fila de baldes de Dial se são inteiros pequenos
+// e radix heap nos demais casos
+//
+// CAMINHOS_HEAP usa sempre o algoritmo de Dijkstra com uma heap binária
+//
+// os resultados não dependem do algoritmo
+
+#define CAMINHOS_AUTOMATICO 0u
+#define CAMINHOS_HEAP 1u
+
+void define_algoritmo_caminhos(grafo* g, unsigned int algoritmo);
+
+//------------------------------------------------------------------------------
+// ordens dos vértices de reordena_vertices()
+//
+// os índices dos vértices vêm da ordem em que eles aparecem na entrada, e vizinhos
+// costumam ficar longe uns dos outros na memória; renumerar os vértices para que
+// vizinhos tenham índices próximos pode acelerar os cálculos de cortes e diâmetros
+//
+// ORDEM_BFS numera os vértices na ordem de uma busca em largura, um componente
+// depois do outro
+//
+// ORDEM_RCM usa a ordem de Cuthill-McKee reversa: buscas em largura que começam no
+// vértice de menor grau e visitam os vizinhos por grau crescente, com a ordem
+// invertida no fim; costuma dar a lista de adjacência de menor banda
+//
+// ORDEM_GRAU numera os vértices por grau decrescente, deixando juntos os de grau alto
+//
+// os nomes acompanham os vértices, então as respostas em "string" e os resultados
+// numéricos não mudam; só mudam os índices
+
+#define ORDEM_BFS 0u
+#define ORDEM_RCM 1u
+#define ORDEM_GRAU 2u
+
+//------------------------------------------------------------------------------
+// renumera os vértices de g na ordem 'ordem' (ORDEM_*)
+//
+// se 'anterior' não é NULL, ele deve ter espaço para n_vertices(g) elementos e
+// recebe em anterior[i] o índice que o vértice de índice i tinha antes; índices
+// obtidos antes da chamada deixam de valer e os resultados já calculados são
+// descartados
+//
+// devolve 1 em caso de sucesso e 0 se 'ordem' não é uma das ORDEM_*
+
+unsigned int reordena_vertices(grafo* g, unsigned int ordem, unsigned int* anterior);
+
+//------------------------------------------------------------------------------
+// devolve o número de execuções de Dijkstra (caminhos mínimos a partir de uma
+// origem) feitas no último cálculo dos diâmetros de g, ou 0 se eles ainda não
+// foram calculados
+
+unsigned int execucoes_dijkstra(grafo* g);
+
 //------------------------------------------------------------------------------
 // devolve o nome de g
 
 char* nome(grafo* g);
 
+//------------------------------------------------------------------------------
+// devolve o número de bytes usados pela arena de g
+//
+// nomes de vértices e resultados calculados a partir de g são alocados numa arena
+// que vive enquanto g existir e é liberada de uma só vez por destroi_grafo(); cada
+// nome ocupa o seu comprimento mais o terminador, sem alinhamento
+
+size_t memoria_arena(grafo* g);
+
+//------------------------------------------------------------------------------
+// contadores de desempenho de g, para saber onde vai o tempo de uma leitura ou
+// análise lenta
+//
+// os contadores só existem se a biblioteca é compilada com -DGRAFO_STATS; sem essa
+// opção a instrumentação não gera código nenhum e estatisticas_grafo() zera 'stats'
+// e devolve 0. Com ela, estatisticas_grafo() copia os contadores em 'stats' e
+// devolve 1, e destroi_grafo() os escreve em stderr se a variável de ambiente
+// GRAFO_STATS está definida e não é vazia nem "0"
+//
+// os tempos são em segundos e somam todas as vezes que a fase foi executada; a
+// bipartição é calculada na mesma busca em largura dos componentes, então o seu
+// tempo está em 'componentes', assim como o da rotulação dos componentes por
+// várias threads (veja define_n_threads()). As filas contadas são as das buscas de caminhos
+// mínimos (heap, baldes ou FIFO) e a da busca dos componentes. 'pico_bytes' é o
+// maior total das estruturas de g e da memória de trabalho da fase em execução,
+// medido no começo de cada fase, e não conta a memória alocada por fora da
+// biblioteca
+
+typedef struct grafo_stats {
+    double leitura; // leitura do arquivo e montagem da lista de adjacência
+    double componentes;
+    double cortes;
+    double diametros;
+    unsigned long long linhas; // linhas da entrada analisadas
+    unsigned long long buscas_nome; // buscas na tabela de nomes dos vértices
+    unsigned long long arestas_relaxadas; // arestas examinadas nos caminhos mínimos
+    unsigned long long insercoes; // inserções nas filas
+    unsigned long long remocoes;
+    unsigned long long reducoes; // reduções de chave (decrease-key)
+    unsigned long long filas_alocadas;
+    size_t pico_bytes;
+} grafo_stats;
+
+unsigned int estatisticas_grafo(grafo* g, grafo_stats* stats);
+
 //------------------------------------------------------------------------------
 // devolve 1 se g é bipartido e 0 caso contrário
 
 unsigned int bipartido(grafo* g);
 
+//------------------------------------------------------------------------------
+// como bipartido(), devolve 1 se g é bipartido e 0 caso contrário, e dá a bipartição
+// ou um ciclo ímpar que prova que ela não existe
+//
+// se g é bipartido e 'cor' não é NULL, cor[i] recebe 0 ou 1, o lado do vértice de
+// índice i; vértices adjacentes ficam em lados diferentes
+//
+// se g não é bipartido, 'ciclo' (se não é NULL) recebe os índices dos vértices de
+// um ciclo ímpar de g, na ordem do ciclo, e 'tam_ciclo' (se não é NULL) o seu
+// comprimento; o ciclo é curto mas não necessariamente o menor ciclo ímpar de g
+//
+// 'cor' e 'ciclo' devem ter espaço para n_vertices(g) elementos
+//
+// a bipartição é calculada junto com os componentes, numa única busca em largura
+
+unsigned int biparticao(
+    grafo* g, unsigned char* cor, unsigned int* ciclo, unsigned int* tam_ciclo);
+
 //------------------------------------------------------------------------------
 // devolve o número de vértices em g
 
 unsigned int n_vertices(grafo* g);
 
+//------------------------------------------------------------------------------
+// devolve o índice do vértice de nome 'nome' em g ou -1 caso ele não exista
+//
+// os vértices são indexados de 0 a n_vertices(g) - 1 na ordem em que aparecem
+// pela primeira vez na entrada, a menos que sejam renumerados por
+// reordena_vertices()
+
+long long int busca_vertice(grafo* g, const char* nome);
+
+//------------------------------------------------------------------------------
+// devolve o nome do vértice de índice 'i' em g ou NULL caso ele não exista
+
+char* nome_vertice(grafo* g, unsigned int i);
+
 //------------------------------------------------------------------------------
 // devolve o número de arestas em g
 
@@ -87,6 +351,58 @@ unsigned int n_componentes(grafo* g);
 
 char* diametros(grafo* g);
 
+//------------------------------------------------------------------------------
+// variantes de diametros(), vertices_corte() e arestas_corte() que não montam a
+// "string" da resposta
+//
+// escreve_*() escreve em f a mesma sequência que a função correspondente devolveria,
+// sem quebra de linha no fim, e devolve 1 em caso de sucesso e 0 em caso de erro
+//
+// visita_*() chama visita(item, dados) para cada item da resposta, na mesma ordem,
+// até que visita devolva algo diferente de 0; cada aresta de corte é um item, com o
+// par de nomes separado por um branco. Cada item vale só durante a chamada de visita
+// e não deve ser alterado. Devolve o número de itens visitados
+//
+// a ordem da resposta é guardada em g, então consultas seguintes não a calculam de novo
+
+unsigned int escreve_diametros(grafo* g, FILE* f);
+unsigned int visita_diametros(grafo* g, int (*visita)(const char* item, void* dados), void* dados);
+
+//------------------------------------------------------------------------------
+// variantes de diametros(), vertices_corte() e arestas_corte() que dão a resposta
+// em números, sem nenhum nome
+//
+// diametros_valores() preenche 'valores' com os diâmetros dos componentes em ordem
+// não decrescente e devolve o número de componentes
+//
+// vertices_corte_indices() preenche 'vertices' com os índices dos vértices de corte
+// e devolve o número deles; arestas_corte_indices() preenche 'extremos' com os
+// índices dos vértices de cada aresta de corte, a i-ésima sendo {extremos[2i],
+// extremos[2i + 1]}, e devolve o número de arestas de corte. A ordem é a mesma de
+// vertices_corte() e arestas_corte()
+//
+// se o vetor é NULL, só o número é devolvido, sem ordenar a resposta; assim dá para
+// saber o tamanho do vetor antes de preenchê-lo. 'extremos' deve ter espaço para o
+// dobro do número de arestas de corte
+
+unsigned int diametros_valores(grafo* g, unsigned int* valores);
+
+//------------------------------------------------------------------------------
+// calcula limites para os diâmetros dos componentes de g sem calcular os diâmetros
+// exatos: cada componente recebe 'varreduras' execuções de Dijkstra (ao menos uma),
+// cada uma a partir do vértice mais distante da origem anterior. A primeira parte
+// de um vértice pseudoperiférico, o mais distante do vértice de menor índice do
+// componente, encontrado por uma execução a mais (com 1 varredura, a "double sweep")
+//
+// o diâmetro do i-ésimo componente fica entre inferior[i] e superior[i], com
+// superior[i] <= 2 * inferior[i]; os componentes são ordenados pelo menor índice
+// de seus vértices e os vetores devem ter espaço para n_componentes(g) elementos
+//
+// devolve o número de componentes
+
+unsigned int diametros_aprox(
+    grafo* g, unsigned int varreduras, unsigned int* inferior, unsigned int* superior);
+
 //------------------------------------------------------------------------------
 // devolve uma "string" com os nomes dos vértices de corte de g em
 // ordem alfabética, separados por brancos
@@ -102,4 +418,54 @@ char* vertices_corte(grafo* g);
 
 char* arestas_corte(grafo* g);
 
+//------------------------------------------------------------------------------
+// variantes de vertices_corte() e arestas_corte() descritas junto de diametros()
+
+unsigned int escreve_vertices_corte(grafo* g, FILE* f);
+unsigned int visita_vertices_corte(
+    grafo* g, int (*visita)(const char* item, void* dados), void* dados);
+unsigned int escreve_arestas_corte(grafo* g, FILE* f);
+unsigned int visita_arestas_corte(
+    grafo* g, int (*visita)(const char* item, void* dados), void* dados);
+
+//------------------------------------------------------------------------------
+// variantes de vertices_corte() e arestas_corte() descritas junto de diametros_valores()
+
+unsigned int vertices_corte_indices(grafo* g, unsigned int* vertices);
+unsigned int arestas_corte_indices(grafo* g, unsigned int* extremos);
+
+//------------------------------------------------------------------------------
+// estrutura biconexa de g, calculada junto com os cortes, numa única busca em
+// profundidade
+//
+// os vetores devolvidos pertencem a g e valem até g ser destruído; não devem ser
+// alterados nem liberados. Laços (arestas de um vértice a ele mesmo) não pertencem
+// a nenhum bloco
+
+//------------------------------------------------------------------------------
+// devolve o número de blocos (componentes biconexos) de g
+//
+// as arestas do bloco b, de 0 ao número de blocos - 1, são {arestas[2k], arestas[2k + 1]}
+// para inicio[b] <= k < inicio[b + 1], com os índices dos seus vértices; cada aresta
+// de g está em exatamente um bloco
+
+unsigned int blocos(grafo* g, const unsigned int** inicio, const unsigned int** arestas);
+
+//------------------------------------------------------------------------------
+// devolve o número de componentes 2-aresta-conexos de g, os componentes que
+// restam quando as arestas de corte são removidas
+//
+// componente[i] é o componente do vértice de índice i, de 0 ao número de componentes - 1
+
+unsigned int componentes_2_arestas(grafo* g, const unsigned int** componente);
+
+//------------------------------------------------------------------------------
+// devolve o número de blocos de g e descreve a árvore de blocos e cortes, que liga
+// cada bloco aos vértices de corte que ele contém
+//
+// os vértices de corte do bloco b (numerado como em blocos()) são cortes[inicio[b]]
+// ... cortes[inicio[b + 1] - 1], com seus índices em g
+
+unsigned int arvore_blocos(grafo* g, const unsigned int** inicio, const unsigned int** cortes);
+
 #endif
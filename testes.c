@@ -0,0 +1,1569 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "grafo.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <dirent.h>
+#include <string.h>
+#include <unistd.h>
+
+// testes de regressão da biblioteca
+//
+// uso: testes (da raiz do repositório, pois alguns testes leem exemplos/)
+//
+// cada teste imprime o seu nome e as verificações que falharam; o programa devolve
+// 0 se todas passaram
+
+#define CHECK(cond) check((cond), #cond, __FILE__, __LINE__)
+
+void check(int ok, const char* what, const char* file, int line);
+grafo* read_text(const char* text);
+grafo* read_file(const char* path);
+void test_edge_count(void);
+void test_arena(void);
+void write_file(char* path, const char* text, size_t len);
+void check_same_reading(grafo* g, grafo* h);
+void test_parser(void);
+void test_parallel_read(void);
+void test_diameter_bounds(void);
+FILE* random_components(unsigned int max_w);
+grafo* reread(FILE* f);
+void check_diameter_modes(grafo* g, grafo* h);
+void test_diameter_modes(void);
+void check_kernel(FILE* f, unsigned int modo);
+void test_kernels(void);
+void test_deep_cuts(void);
+int comp_unsigned(const void* a, const void* b);
+int comp_string(const void* a, const void* b);
+char* join_sorted(char** items, size_t n, const char* sep);
+char* edge_text(grafo* g, unsigned int a, unsigned int b);
+char* describe_blocks(grafo* g);
+char* describe_2ecc(grafo* g);
+void test_blocks(void);
+unsigned long next_random(void);
+void append_text(char* text, size_t size, const char* line);
+void check_bipartition(grafo* g, unsigned char adj[][16]);
+void check_same_results(grafo* g, grafo* h);
+void test_insertions(void);
+void check_same_cuts(grafo* g, grafo* h);
+void insert_and_check(grafo* g, char* text, size_t size, const char* x, const char* y);
+void test_cut_insertions(void);
+unsigned int count_files(const char* dir);
+grafo* save_and_load(grafo* g, const char* path);
+void test_snapshot(void);
+int collect_item(const char* item, void* dados);
+void check_streaming(grafo* g);
+void test_streaming(void);
+void test_empty(void);
+void check_reorder(grafo* g, grafo* h, unsigned int ordem);
+void test_reorder(void);
+grafo* read_random(FILE* f, unsigned int n, unsigned int m);
+void test_thread_components(void);
+void test_stats(void);
+
+static unsigned int n_checks, n_failures;
+static unsigned long long random_state = 88172645463325252ull;
+
+//------------------------------------------------------------------------------
+// conta a verificação 'what' e a imprime se ela falhou
+void check(int ok, const char* what, const char* file, int line)
+{
+    n_checks++;
+    if (!ok) {
+        n_failures++;
+        printf("  falhou %s:%d: %s\n", file, line, what);
+    }
+}
+
+//------------------------------------------------------------------------------
+// lê um grafo do texto 'text', no formato de le_grafo()
+grafo* read_text(const char* text)
+{
+    FILE* f = fmemopen((void*)(size_t)text, strlen(text), "r");
+    grafo* g;
+
+    if (!f) {
+        fprintf(stderr, "nao foi possivel abrir o texto do grafo\n");
+        exit(EXIT_FAILURE);
+    }
+    g = le_grafo(f);
+    fclose(f);
+
+    return g;
+}
+
+//------------------------------------------------------------------------------
+// lê com le_grafo() o grafo do arquivo 'path', ou devolve NULL se ele não abre
+grafo* read_file(const char* path)
+{
+    FILE* f = fopen(path, "r");
+    grafo* g;
+
+    if (!f)
+        return NULL;
+    g = le_grafo(f);
+    fclose(f);
+
+    return g;
+}
+
+//------------------------------------------------------------------------------
+// arestas repetidas contam uma vez, com o peso da primeira lida, e um laço conta
+// como uma aresta
+void test_edge_count(void)
+{
+    grafo* g = read_text("repetidas\n"
+                         "a -- b 3\n"
+                         "b -- a 5\n"
+                         "a -- b\n"
+                         "a -- a\n"
+                         "a -- a 2\n"
+                         "b -- c 1\n"
+                         "d\n");
+    char* s;
+
+    CHECK(n_vertices(g) == 4);
+    CHECK(n_arestas(g) == 3);
+    CHECK(n_componentes(g) == 2);
+    s = diametros(g);
+    CHECK(strcmp(s, "0 4") == 0);
+    free(s);
+    destroi_grafo(g);
+
+    // exemplos/cidades.dot repete arestas, às vezes em sentidos opostos
+    g = read_file("exemplos/cidades.dot");
+    CHECK(g != NULL);
+    if (g) {
+        CHECK(n_arestas(g) == 2058);
+        destroi_grafo(g);
+    }
+}
+
+//------------------------------------------------------------------------------
+// a arena guarda cada nome com o seu terminador, sem preenchimento de alinhamento
+void test_arena(void)
+{
+    grafo* g = read_text("arena\n"
+                         "a -- bc 1\n"
+                         "bc -- def 2\n"
+                         "a\n");
+
+    // "arena", "a", "bc" e "def", cada um com o '\0'
+    CHECK(memoria_arena(g) == 6 + 2 + 3 + 4);
+
+    // as análises de um grafo bipartido não usam a arena
+    CHECK(n_componentes(g) == 1);
+    CHECK(bipartido(g) == 1);
+    CHECK(memoria_arena(g) == 15);
+    destroi_grafo(g);
+
+    // nem as de um grafo com ciclo ímpar, refeitas depois de cada renumeração e de
+    // cada inserção
+    g = read_text("impar\n"
+                  "a -- b 1\n"
+                  "b -- c 1\n"
+                  "c -- a 1\n");
+    CHECK(bipartido(g) == 0);
+    CHECK(memoria_arena(g) == 6 + 2 * 3);
+    for (int i = 0; i < 10; i++) {
+        CHECK(reordena_vertices(g, ORDEM_GRAU, NULL) == 1);
+        CHECK(bipartido(g) == 0);
+        CHECK(adiciona_aresta(g, "a", "b", 1) == 1);
+        CHECK(bipartido(g) == 0);
+    }
+    CHECK(memoria_arena(g) == 6 + 2 * 3);
+    destroi_grafo(g);
+}
+
+//------------------------------------------------------------------------------
+// cria o arquivo temporário de modelo 'path', que recebe o nome criado, com os
+// 'len' bytes de 'text'
+void write_file(char* path, const char* text, size_t len)
+{
+    int fd = mkstemp(path);
+    FILE* f;
+
+    if ((fd < 0) || !(f = fdopen(fd, "w"))) {
+        fprintf(stderr, "nao foi possivel criar arquivo temporario\n");
+        exit(EXIT_FAILURE);
+    }
+    if ((fwrite(text, 1, len, f) != len) | fclose(f)) {
+        fprintf(stderr, "nao foi possivel escrever %s\n", path);
+        exit(EXIT_FAILURE);
+    }
+}
+
+//------------------------------------------------------------------------------
+// g e h têm o mesmo nome, os mesmos vértices na mesma ordem, as mesmas arestas,
+// componentes e cortes
+void check_same_reading(grafo* g, grafo* h)
+{
+    unsigned int n = n_vertices(g);
+    int same = 1;
+
+    CHECK(strcmp(nome(g), nome(h)) == 0);
+    CHECK(n == n_vertices(h));
+    for (unsigned int i = 0; (i < n) && same; i++)
+        same = (nome_vertice(h, i) != NULL) && !strcmp(nome_vertice(g, i), nome_vertice(h, i));
+    CHECK(same);
+    CHECK(n_arestas(g) == n_arestas(h));
+    CHECK(n_componentes(g) == n_componentes(h));
+    check_same_cuts(g, h);
+}
+
+//------------------------------------------------------------------------------
+// le_grafo_arquivo() lê o mesmo grafo que le_grafo(): peso omitido, espaços no
+// fim da linha, fim de linha CRLF, última linha sem '\n' e nomes do tamanho máximo
+// de uma linha de le_grafo()
+void test_parser(void)
+{
+    // a linha dos nomes longos tem 2047 bytes com o '\n', o máximo que le_grafo()
+    // lê de uma vez
+    char text[4096], x[1021], y[1021];
+    char path[] = "/tmp/testesXXXXXX";
+    grafo *g, *h;
+    char* s;
+    int len;
+
+    memset(x, 'x', sizeof(x) - 1);
+    memset(y, 'y', sizeof(y) - 1);
+    x[sizeof(x) - 1] = y[sizeof(y) - 1] = '\0';
+    len = snprintf(text, sizeof(text),
+        "leitura\n"
+        "// comentario\n"
+        "a -- b\n"
+        "b -- c 4   \t\n"
+        "c -- d 2\r\n"
+        "e  \n"
+        "\n"
+        "%s -- %s 7\n"
+        "d -- a 3",
+        x, y);
+    CHECK(strlen(strstr(text, x)) == 2047 + strlen("d -- a 3"));
+
+    g = read_text(text);
+    write_file(path, text, (size_t)len);
+    h = le_grafo_arquivo(path);
+    CHECK(h != NULL);
+    if (!h) {
+        destroi_grafo(g);
+        unlink(path);
+        return;
+    }
+
+    check_same_reading(g, h);
+    CHECK(n_vertices(h) == 7);
+    CHECK(n_arestas(h) == 5);
+    CHECK(n_componentes(h) == 3);
+    CHECK(busca_vertice(h, "e") == 4);
+    CHECK(busca_vertice(h, x) == 5);
+    CHECK(busca_vertice(h, y) == 6);
+
+    // o ciclo a b c d tem pesos 1 (omitido), 4, 2 e 3
+    s = diametros(g);
+    CHECK(strcmp(s, "0 5 7") == 0);
+    free(s);
+    s = diametros(h);
+    CHECK(strcmp(s, "0 5 7") == 0);
+    free(s);
+
+    destroi_grafo(g);
+    destroi_grafo(h);
+    unlink(path);
+}
+
+//------------------------------------------------------------------------------
+// le_grafo_arquivo_paralelo() com 2, 3 e 4 threads lê o mesmo grafo que le_grafo()
+// e le_grafo_arquivo() num arquivo de alguns MiB, grande o bastante para ser dividido
+// entre as threads; os nomes se repetem entre as partes e nomes novos aparecem até o
+// fim, então as tabelas de nomes das threads precisam ser unidas e os índices
+// renumerados na ordem da entrada
+void test_parallel_read(void)
+{
+    size_t size = 4u << 20, len = 0;
+    char path[] = "/tmp/testesXXXXXX";
+    char* text = malloc(size);
+    FILE* f;
+    grafo *g, *h;
+
+    if (!text) {
+        fprintf(stderr, "nao foi possivel alocar o texto do grafo\n");
+        exit(EXIT_FAILURE);
+    }
+    len += (size_t)sprintf(text, "paralelo\n");
+    for (unsigned long i = 0; len + 64 < size; i++) {
+        unsigned long n = 1000 + i / 4;
+
+        if (i % 1000 == 0)
+            len += (size_t)sprintf(text + len, "// linha %lu\n", i);
+        else if (i % 997 == 0)
+            len += (size_t)sprintf(text + len, "u%lu\n", i);
+        else
+            len += (size_t)sprintf(text + len, "v%lu -- v%lu %lu%s\n", next_random() % n,
+                next_random() % n, 1 + next_random() % 100, (i % 101 == 0) ? "\r" : "");
+    }
+    write_file(path, text, len);
+
+    if (!(f = fmemopen(text, len, "r"))) {
+        fprintf(stderr, "nao foi possivel abrir o texto do grafo\n");
+        exit(EXIT_FAILURE);
+    }
+    g = le_grafo(f);
+    fclose(f);
+    CHECK(g != NULL);
+
+    for (unsigned int n_threads = 1; g && (n_threads <= 4); n_threads++) {
+        h = (n_threads == 1) ? le_grafo_arquivo(path) : le_grafo_arquivo_paralelo(path, n_threads);
+        CHECK(h != NULL);
+        if (h) {
+            check_same_reading(g, h);
+            destroi_grafo(h);
+        }
+    }
+
+    if (g)
+        destroi_grafo(g);
+    free(text);
+    unlink(path);
+}
+
+//------------------------------------------------------------------------------
+int comp_unsigned(const void* a, const void* b)
+{
+    unsigned int x = *(const unsigned int*)a, y = *(const unsigned int*)b;
+
+    return (x > y) - (x < y);
+}
+
+//------------------------------------------------------------------------------
+// os limites de diametros_aprox() cercam os diâmetros exatos, com o superior no
+// máximo o dobro do inferior
+void test_diameter_bounds(void)
+{
+    const char* files[] = { "exemplos/cidades.dot", "exemplos/heawood.dot",
+        "exemplos/paises.dot", "exemplos/petersen.dot", "exemplos/teste1.in",
+        "exemplos/teste2.in", "exemplos/teste3.in", "exemplos/teste4.in",
+        "exemplos/teste5.in" };
+    unsigned int lower[2], upper[2];
+    grafo* g;
+
+    // os componentes vêm na ordem do seu menor índice: {a, b, f} e {c, d, e}
+    g = read_text("dois\n"
+                  "a -- b 2\n"
+                  "c -- d 1\n"
+                  "d -- e 1\n"
+                  "a -- f 1\n");
+    CHECK(diametros_aprox(g, 2, lower, upper) == 2);
+    CHECK((lower[0] <= 3) && (3 <= upper[0]) && (lower[1] <= 2) && (2 <= upper[1]));
+    destroi_grafo(g);
+
+    for (size_t i = 0; i < sizeof(files) / sizeof(files[0]); i++) {
+        unsigned int *exact, *lo, *hi, n;
+        char *text, *end;
+
+        if (!(g = le_grafo_arquivo(files[i]))) {
+            CHECK(!"exemplo não pôde ser lido");
+            continue;
+        }
+        n = n_componentes(g);
+        exact = malloc(sizeof(unsigned int) * n);
+        lo = malloc(sizeof(unsigned int) * n);
+        hi = malloc(sizeof(unsigned int) * n);
+        if (!exact || !lo || !hi) {
+            fprintf(stderr, "nao foi possivel alocar diametros\n");
+            exit(EXIT_FAILURE);
+        }
+
+        for (unsigned int varreduras = 1; varreduras <= 4; varreduras++) {
+            CHECK(diametros_aprox(g, varreduras, lo, hi) == n);
+            for (unsigned int c = 0; c < n; c++)
+                CHECK((lo[c] <= hi[c]) && (hi[c] <= 2 * lo[c]));
+
+            // diametros() dá os diâmetros em ordem crescente, então os limites são
+            // comparados ordenados: se lo[c] <= d[c] <= hi[c] para cada componente,
+            // o mesmo vale para os três vetores ordenados
+            text = diametros(g);
+            end = text;
+            for (unsigned int c = 0; c < n; c++)
+                exact[c] = (unsigned int)strtoul(end, &end, 10);
+            CHECK(*end == '\0');
+            free(text);
+            qsort(lo, n, sizeof(unsigned int), comp_unsigned);
+            qsort(hi, n, sizeof(unsigned int), comp_unsigned);
+            for (unsigned int c = 0; c < n; c++)
+                CHECK((lo[c] <= exact[c]) && (exact[c] <= hi[c]));
+        }
+
+        free(exact);
+        free(lo);
+        free(hi);
+        destroi_grafo(g);
+    }
+}
+
+//------------------------------------------------------------------------------
+// devolve um arquivo temporário com um grafo de pesos aleatórios de 1 a 'max_w': um
+// vértice isolado, um componente de dois vértices e componentes maiores, cada um uma
+// árvore aleatória com outras tantas arestas entre os seus vértices
+FILE* random_components(unsigned int max_w)
+{
+    FILE* f = tmpfile();
+
+    if (!f) {
+        fprintf(stderr, "nao foi possivel criar arquivo temporario\n");
+        exit(EXIT_FAILURE);
+    }
+    fprintf(f, "componentes\nisolado\n");
+    fprintf(f, "par0 -- par1 %lu\n", 1 + next_random() % max_w);
+    for (unsigned int c = 0; c < 4; c++) {
+        unsigned long k = 3 + next_random() % 150;
+
+        for (unsigned long i = 1; i < k; i++)
+            fprintf(f, "c%u_%lu -- c%u_%lu %lu\n", c, i, c, next_random() % i,
+                1 + next_random() % max_w);
+        for (unsigned long i = 0; i < k; i++)
+            fprintf(f, "c%u_%lu -- c%u_%lu %lu\n", c, next_random() % k, c,
+                next_random() % k, 1 + next_random() % max_w);
+    }
+
+    return f;
+}
+
+//------------------------------------------------------------------------------
+// lê o grafo do início do arquivo 'f'
+grafo* reread(FILE* f)
+{
+    rewind(f);
+
+    return le_grafo(f);
+}
+
+//------------------------------------------------------------------------------
+// g, com os diâmetros por limites, e h, com Dijkstra de todas as origens, têm os
+// mesmos diâmetros, e g precisa de menos execuções de Dijkstra
+void check_diameter_modes(grafo* g, grafo* h)
+{
+    unsigned int n = n_componentes(g);
+    unsigned int *a = malloc(sizeof(unsigned int) * n), *b = malloc(sizeof(unsigned int) * n);
+    int same = 1;
+
+    if (!a || !b) {
+        fprintf(stderr, "nao foi possivel alocar diametros\n");
+        exit(EXIT_FAILURE);
+    }
+    define_modo_diametro(h, DIAMETRO_TODAS_ORIGENS);
+    CHECK(diametros_valores(g, a) == n);
+    CHECK(diametros_valores(h, b) == n);
+    for (unsigned int c = 0; c < n; c++)
+        same = same && (a[c] == b[c]);
+    CHECK(same);
+    CHECK(execucoes_dijkstra(h) == n_vertices(h));
+    CHECK(execucoes_dijkstra(g) < n_vertices(g));
+
+    free(a);
+    free(b);
+}
+
+//------------------------------------------------------------------------------
+// os diâmetros por limites de excentricidade são os de Dijkstra de todas as origens
+void test_diameter_modes(void)
+{
+    const char* files[] = { "exemplos/cidades.dot", "exemplos/heawood.dot",
+        "exemplos/paises.dot", "exemplos/petersen.dot", "exemplos/teste1.in",
+        "exemplos/teste2.in", "exemplos/teste3.in", "exemplos/teste4.in",
+        "exemplos/teste5.in" };
+    grafo *g, *h;
+
+    for (size_t i = 0; i < sizeof(files) / sizeof(files[0]); i++) {
+        g = le_grafo_arquivo(files[i]);
+        h = le_grafo_arquivo(files[i]);
+        CHECK(g && h);
+        if (g && h)
+            check_diameter_modes(g, h);
+        if (g)
+            destroi_grafo(g);
+        if (h)
+            destroi_grafo(h);
+    }
+
+    for (unsigned int seed = 0; seed < 20; seed++) {
+        FILE* f = random_components(seed % 2 ? 20 : 1000);
+
+        g = reread(f);
+        h = reread(f);
+        check_diameter_modes(g, h);
+        destroi_grafo(g);
+        destroi_grafo(h);
+        fclose(f);
+    }
+}
+
+//------------------------------------------------------------------------------
+// o grafo do arquivo 'f' tem os mesmos diâmetros e limites de diametros_aprox() com
+// o algoritmo de caminhos escolhido pelos pesos e com a heap binária, no modo de
+// diâmetro 'modo'
+void check_kernel(FILE* f, unsigned int modo)
+{
+    grafo* g = reread(f);
+    grafo* h = reread(f);
+    unsigned int n = n_componentes(g);
+    unsigned int* v = malloc(sizeof(unsigned int) * 6 * n);
+    int same = 1;
+
+    if (!v) {
+        fprintf(stderr, "nao foi possivel alocar diametros\n");
+        exit(EXIT_FAILURE);
+    }
+    define_algoritmo_caminhos(h, CAMINHOS_HEAP);
+    define_modo_diametro(g, modo);
+    define_modo_diametro(h, modo);
+
+    CHECK(diametros_valores(g, v) == n);
+    CHECK(diametros_valores(h, v + n) == n);
+    CHECK(diametros_aprox(g, 2, v + 2 * n, v + 3 * n) == n);
+    CHECK(diametros_aprox(h, 2, v + 4 * n, v + 5 * n) == n);
+    for (unsigned int i = 0; i < n; i++)
+        same = same && (v[i] == v[n + i]) && (v[2 * n + i] == v[4 * n + i])
+            && (v[3 * n + i] == v[5 * n + i]);
+    CHECK(same);
+
+    free(v);
+    destroi_grafo(g);
+    destroi_grafo(h);
+}
+
+//------------------------------------------------------------------------------
+// a busca em largura (pesos 1), a fila de baldes de Dial (pesos até 255) e a radix
+// heap (pesos maiores) dão as mesmas distâncias que a heap binária
+void test_kernels(void)
+{
+    const unsigned int max_w[] = { 1, 255, 100000 };
+
+    for (unsigned int seed = 0; seed < 30; seed++) {
+        FILE* f = random_components(max_w[seed % 3]);
+
+        check_kernel(f, DIAMETRO_LIMITES);
+        check_kernel(f, DIAMETRO_TODAS_ORIGENS);
+        fclose(f);
+    }
+}
+
+//------------------------------------------------------------------------------
+// num caminho de um milhão de vértices, mais profundo do que uma busca recursiva
+// aguentaria na pilha de chamadas, todos os vértices menos as pontas são de corte e
+// todas as arestas são pontes
+void test_deep_cuts(void)
+{
+    const unsigned int n = 1000000;
+    FILE* f = tmpfile();
+    grafo* g;
+
+    if (!f) {
+        fprintf(stderr, "nao foi possivel criar arquivo temporario\n");
+        exit(EXIT_FAILURE);
+    }
+    fprintf(f, "caminho\n");
+    for (unsigned int i = 1; i < n; i++)
+        fprintf(f, "p%u -- p%u\n", i - 1, i);
+
+    g = reread(f);
+    fclose(f);
+    CHECK(n_vertices(g) == n);
+    CHECK(vertices_corte_indices(g, NULL) == n - 2);
+    CHECK(arestas_corte_indices(g, NULL) == n - 1);
+    destroi_grafo(g);
+}
+
+//------------------------------------------------------------------------------
+int comp_string(const void* a, const void* b)
+{
+    return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+//------------------------------------------------------------------------------
+// ordena as 'n' strings de 'items', as libera e devolve uma string com elas separadas
+// por 'sep'
+char* join_sorted(char** items, size_t n, const char* sep)
+{
+    size_t len = 1;
+    char* out;
+
+    qsort(items, n, sizeof(char*), comp_string);
+    for (size_t i = 0; i < n; i++)
+        len += strlen(items[i]) + strlen(sep);
+    if (!(out = malloc(len))) {
+        fprintf(stderr, "nao foi possivel alocar texto\n");
+        exit(EXIT_FAILURE);
+    }
+
+    out[0] = '\0';
+    for (size_t i = 0; i < n; i++) {
+        if (i > 0)
+            strcat(out, sep);
+        strcat(out, items[i]);
+        free(items[i]);
+    }
+
+    return out;
+}
+
+//------------------------------------------------------------------------------
+// devolve o texto "x-y" da aresta {a, b} de g, com os nomes em ordem alfabética
+char* edge_text(grafo* g, unsigned int a, unsigned int b)
+{
+    char *x = nome_vertice(g, a), *y = nome_vertice(g, b);
+    char* out = malloc(strlen(x) + strlen(y) + 2);
+
+    if (!out) {
+        fprintf(stderr, "nao foi possivel alocar texto\n");
+        exit(EXIT_FAILURE);
+    }
+    if (strcmp(x, y) > 0) {
+        char* t = x;
+        x = y;
+        y = t;
+    }
+    sprintf(out, "%s-%s", x, y);
+
+    return out;
+}
+
+//------------------------------------------------------------------------------
+// descreve os blocos de g, cada um com as suas arestas e, depois de '/', os seus
+// vértices de corte, num texto que não depende da numeração dos blocos nem dos
+// vértices
+char* describe_blocks(grafo* g)
+{
+    const unsigned int *start, *edges, *cut_start, *cuts;
+    unsigned int n = blocos(g, &start, &edges);
+    char** block = malloc(sizeof(char*) * (n + 1));
+
+    if (!block || (arvore_blocos(g, &cut_start, &cuts) != n)) {
+        fprintf(stderr, "nao foi possivel descrever os blocos\n");
+        exit(EXIT_FAILURE);
+    }
+
+    for (unsigned int b = 0; b < n; b++) {
+        size_t n_edges = start[b + 1] - start[b], n_cuts = cut_start[b + 1] - cut_start[b];
+        char** item = malloc(sizeof(char*) * (n_edges + n_cuts + 1));
+        char *e, *c;
+
+        if (!item) {
+            fprintf(stderr, "nao foi possivel descrever os blocos\n");
+            exit(EXIT_FAILURE);
+        }
+        for (size_t k = 0; k < n_edges; k++)
+            item[k] = edge_text(g, edges[2 * (start[b] + k)], edges[2 * (start[b] + k) + 1]);
+        e = join_sorted(item, n_edges, " ");
+        for (size_t k = 0; k < n_cuts; k++)
+            item[k] = strdup(nome_vertice(g, cuts[cut_start[b] + k]));
+        c = join_sorted(item, n_cuts, " ");
+
+        block[b] = malloc(strlen(e) + strlen(c) + 4);
+        if (!block[b]) {
+            fprintf(stderr, "nao foi possivel descrever os blocos\n");
+            exit(EXIT_FAILURE);
+        }
+        sprintf(block[b], "%s / %s", e, c);
+        free(e);
+        free(c);
+        free(item);
+    }
+
+    char* out = join_sorted(block, n, "; ");
+    free(block);
+
+    return out;
+}
+
+//------------------------------------------------------------------------------
+// descreve os componentes 2-aresta-conexos de g, cada um com os nomes dos seus
+// vértices, num texto que não depende da numeração dos componentes
+char* describe_2ecc(grafo* g)
+{
+    const unsigned int* comp;
+    unsigned int n = componentes_2_arestas(g, &comp);
+    char** group = malloc(sizeof(char*) * (n + 1));
+    char** item = malloc(sizeof(char*) * (n_vertices(g) + 1));
+
+    if (!group || !item) {
+        fprintf(stderr, "nao foi possivel descrever os componentes\n");
+        exit(EXIT_FAILURE);
+    }
+
+    for (unsigned int c = 0; c < n; c++) {
+        size_t size = 0;
+
+        for (unsigned int v = 0; v < n_vertices(g); v++)
+            if (comp[v] == c)
+                item[size++] = strdup(nome_vertice(g, v));
+        group[c] = join_sorted(item, size, " ");
+    }
+
+    char* out = join_sorted(group, n, "; ");
+    free(group);
+    free(item);
+
+    return out;
+}
+
+//------------------------------------------------------------------------------
+// blocos, componentes 2-aresta-conexos e árvore de blocos e cortes de grafos
+// pequenos com a resposta conhecida
+void test_blocks(void)
+{
+    struct {
+        const char* text;
+        const char* blocks;
+        const char* two_edge;
+    } cases[] = {
+        // gravata borboleta: dois triângulos com um vértice em comum
+        { "gravata\na -- b\nb -- c\nc -- a\nc -- d\nd -- e\ne -- c\n",
+            "a-b a-c b-c / c; c-d c-e d-e / c", "a b c d e" },
+        // ciclo com uma aresta pendurada, que é uma ponte
+        { "pendente\na -- b\nb -- c\nc -- d\nd -- a\nd -- e\n",
+            "a-b a-d b-c c-d / d; d-e / d", "a b c d; e" },
+        // dois triângulos ligados por uma ponte
+        { "corrente\na -- b\nb -- c\nc -- a\nc -- d\nd -- e\ne -- f\nf -- d\n",
+            "a-b a-c b-c / c; c-d / c d; d-e d-f e-f / d", "a b c; d e f" },
+        // um laço não pertence a nenhum bloco, e um vértice isolado não tem blocos
+        { "laco\na -- a\na -- b\nc\n", "a-b / ", "a; b; c" },
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        grafo* g = read_text(cases[i].text);
+        char* s;
+
+        s = describe_blocks(g);
+        CHECK(strcmp(s, cases[i].blocks) == 0);
+        free(s);
+        s = describe_2ecc(g);
+        CHECK(strcmp(s, cases[i].two_edge) == 0);
+        free(s);
+        destroi_grafo(g);
+    }
+}
+
+//------------------------------------------------------------------------------
+// devolve o próximo número da sequência pseudoaleatória (xorshift64*)
+unsigned long next_random(void)
+{
+    random_state ^= random_state >> 12;
+    random_state ^= random_state << 25;
+    random_state ^= random_state >> 27;
+
+    return (unsigned long)((random_state * 0x2545f4914f6cdd1dull) >> 32);
+}
+
+//------------------------------------------------------------------------------
+// acrescenta 'line' ao texto de um grafo em 'text', de 'size' bytes
+void append_text(char* text, size_t size, const char* line)
+{
+    if (strlen(text) + strlen(line) >= size) {
+        fprintf(stderr, "texto do grafo grande demais\n");
+        exit(EXIT_FAILURE);
+    }
+    strcat(text, line);
+}
+
+//------------------------------------------------------------------------------
+// verifica a resposta de biparticao() para g, cujos vértices se chamam v0 ... v15 e
+// cujas arestas estão na matriz 'adj', indexada pelo número do nome de cada vértice:
+// uma coloração própria, ou um ciclo ímpar de g
+void check_bipartition(grafo* g, unsigned char adj[][16])
+{
+    unsigned int n = n_vertices(g), len = 0;
+    unsigned char* color = malloc(n + 1);
+    unsigned int* cycle = malloc(sizeof(unsigned int) * (n + 1));
+    unsigned int* id = malloc(sizeof(unsigned int) * (n + 1));
+
+    if (!color || !cycle || !id) {
+        fprintf(stderr, "nao foi possivel alocar bipartição\n");
+        exit(EXIT_FAILURE);
+    }
+    for (unsigned int i = 0; i < n; i++)
+        id[i] = (unsigned int)atoi(nome_vertice(g, i) + 1);
+
+    if (biparticao(g, color, cycle, &len)) {
+        for (unsigned int i = 0; i < n; i++)
+            for (unsigned int j = 0; j < n; j++)
+                if (adj[id[i]][id[j]])
+                    CHECK(color[i] != color[j]);
+    } else {
+        CHECK((len % 2 == 1) && (len <= n));
+        for (unsigned int i = 0; (len <= n) && (i < len); i++)
+            CHECK(adj[id[cycle[i]]][id[cycle[(i + 1) % len]]]);
+    }
+
+    free(color);
+    free(cycle);
+    free(id);
+}
+
+//------------------------------------------------------------------------------
+// verifica que g, alterado por inserções, dá os mesmos resultados que h, lido do
+// zero com as mesmas arestas
+void check_same_results(grafo* g, grafo* h)
+{
+    char *s, *t;
+
+    CHECK(n_vertices(g) == n_vertices(h));
+    CHECK(n_arestas(g) == n_arestas(h));
+    CHECK(n_componentes(g) == n_componentes(h));
+    CHECK(bipartido(g) == bipartido(h));
+    s = diametros(g);
+    t = diametros(h);
+    CHECK(strcmp(s, t) == 0);
+    free(s);
+    free(t);
+}
+
+//------------------------------------------------------------------------------
+// n_componentes() e bipartido() mantidos pela union-find com paridade durante as
+// inserções, e os demais resultados recalculados, são iguais aos de uma leitura do
+// grafo com as mesmas arestas
+void test_insertions(void)
+{
+    unsigned int cycle[3], len = 0;
+    char text[4096], line[64];
+    grafo *g, *h;
+
+    // um ciclo par mantém a bipartição, uma aresta que fecha um ciclo ímpar a desfaz
+    g = read_text("caminho\na -- b\nb -- c\n");
+    CHECK((n_componentes(g) == 1) && bipartido(g));
+    adiciona_aresta(g, "c", "d", 1);
+    adiciona_aresta(g, "d", "a", 1);
+    CHECK((n_componentes(g) == 1) && bipartido(g) && (n_arestas(g) == 4));
+    adiciona_aresta(g, "a", "c", 1);
+    CHECK(!bipartido(g) && !biparticao(g, NULL, cycle, &len) && (len == 3));
+    adiciona_vertice(g, "e");
+    CHECK((n_componentes(g) == 2) && (n_vertices(g) == 5));
+    adiciona_aresta(g, "e", "a", 1);
+    CHECK((n_componentes(g) == 1) && !bipartido(g));
+    destroi_grafo(g);
+
+    // um laço é um ciclo ímpar
+    g = read_text("laco\na -- b\n");
+    CHECK(bipartido(g) == 1);
+    adiciona_aresta(g, "b", "b", 1);
+    CHECK(!bipartido(g) && !biparticao(g, NULL, NULL, &len) && (len == 1));
+    destroi_grafo(g);
+
+    // sequências aleatórias de inserções; os resultados são consultados a cada passo,
+    // então um resultado guardado que não fosse descartado numa inserção apareceria
+    for (unsigned int seed = 0; seed < 200; seed++) {
+        unsigned char adj[16][16];
+        unsigned int n = 2 + (unsigned int)(next_random() % 14);
+        unsigned int m = (unsigned int)(next_random() % (2 * n + 1));
+        unsigned int loaded = (unsigned int)(next_random() % (m + 1));
+
+        memset(adj, 0, sizeof(adj));
+        snprintf(text, sizeof(text), "aleatorio%u\n", seed);
+        for (unsigned int i = 0; i < loaded; i++) {
+            unsigned int a = (unsigned int)(next_random() % n);
+            unsigned int b = (unsigned int)(next_random() % n);
+            snprintf(line, sizeof(line), "v%u -- v%u %lu\n", a, b, 1 + next_random() % 3);
+            append_text(text, sizeof(text), line);
+            adj[a][b] = adj[b][a] = 1;
+        }
+        g = read_text(text);
+        if (next_random() % 2)
+            pre_calcula(g, CALCULA_TUDO);
+
+        for (unsigned int i = loaded; i < m; i++) {
+            unsigned int a = (unsigned int)(next_random() % n);
+            unsigned int b = (unsigned int)(next_random() % n);
+            unsigned long w = 1 + next_random() % 3;
+            char x[16], y[16];
+
+            snprintf(x, sizeof(x), "v%u", a);
+            snprintf(y, sizeof(y), "v%u", b);
+            if (next_random() % 8 == 0) {
+                adiciona_vertice(g, x);
+                snprintf(line, sizeof(line), "%s\n", x);
+            } else {
+                adiciona_aresta(g, x, y, (unsigned int)w);
+                snprintf(line, sizeof(line), "%s -- %s %lu\n", x, y, w);
+                adj[a][b] = adj[b][a] = 1;
+            }
+            append_text(text, sizeof(text), line);
+
+            if (next_random() % 4 == 0)
+                continue;
+            h = read_text(text);
+            check_same_results(g, h);
+            check_bipartition(g, adj);
+            destroi_grafo(h);
+        }
+
+        h = read_text(text);
+        check_same_results(g, h);
+        destroi_grafo(h);
+        destroi_grafo(g);
+    }
+}
+
+//------------------------------------------------------------------------------
+// verifica que g, alterado por inserções, tem os mesmos vértices e arestas de corte
+// que h, lido do zero com as mesmas arestas
+void check_same_cuts(grafo* g, grafo* h)
+{
+    char *s, *t;
+
+    s = vertices_corte(g);
+    t = vertices_corte(h);
+    CHECK(strcmp(s, t) == 0);
+    free(s);
+    free(t);
+    s = arestas_corte(g);
+    t = arestas_corte(h);
+    CHECK(strcmp(s, t) == 0);
+    free(s);
+    free(t);
+}
+
+//------------------------------------------------------------------------------
+// insere em g a aresta {x, y} e no texto 'text', de 'size' bytes, a linha dela, e
+// compara os cortes de g com os de uma leitura do texto
+void insert_and_check(grafo* g, char* text, size_t size, const char* x, const char* y)
+{
+    char line[64];
+    grafo* h;
+
+    adiciona_aresta(g, x, y, 1);
+    snprintf(line, sizeof(line), "%s -- %s\n", x, y);
+    append_text(text, size, line);
+
+    h = read_text(text);
+    check_same_cuts(g, h);
+    destroi_grafo(h);
+}
+
+//------------------------------------------------------------------------------
+// os cortes mantidos na floresta de blocos e cortes durante as inserções são iguais
+// aos de uma leitura do grafo com as mesmas arestas
+void test_cut_insertions(void)
+{
+    char text[4096];
+    char* s;
+    grafo* g;
+
+    // no caminho a - b - c - d todas as arestas são pontes; a aresta {a, c} fecha um
+    // ciclo e as pontes dele deixam de sê-lo
+    strcpy(text, "caminho\na -- b\nb -- c\nc -- d\n");
+    g = read_text(text);
+    s = arestas_corte(g);
+    CHECK(strcmp(s, "a b b c c d") == 0);
+    free(s);
+    insert_and_check(g, text, sizeof(text), "a", "c");
+    s = arestas_corte(g);
+    CHECK(strcmp(s, "c d") == 0);
+    free(s);
+    s = vertices_corte(g);
+    CHECK(strcmp(s, "c") == 0);
+    free(s);
+
+    // uma aresta entre dois componentes é uma ponte nova
+    insert_and_check(g, text, sizeof(text), "e", "f");
+    insert_and_check(g, text, sizeof(text), "d", "e");
+    s = arestas_corte(g);
+    CHECK(strcmp(s, "c d d e e f") == 0);
+    free(s);
+
+    // um laço não muda os cortes, e uma aresta repetida também não
+    insert_and_check(g, text, sizeof(text), "f", "f");
+    insert_and_check(g, text, sizeof(text), "d", "c");
+    insert_and_check(g, text, sizeof(text), "f", "a");
+    s = arestas_corte(g);
+    CHECK(strcmp(s, "") == 0);
+    free(s);
+    destroi_grafo(g);
+
+    // sequências aleatórias de inserções em grafos com os cortes já calculados; os
+    // blocos, que não são mantidos nas inserções, só são comparados no fim, pois
+    // calculá-los calcula também os cortes do zero
+    for (unsigned int seed = 0; seed < 200; seed++) {
+        unsigned int n = 2 + (unsigned int)(next_random() % 14);
+        unsigned int m = (unsigned int)(next_random() % (2 * n + 1));
+        unsigned int loaded = (unsigned int)(next_random() % (m + 1));
+        char line[64], x[16], y[16];
+
+        snprintf(text, sizeof(text), "aleatorio%u\n", seed);
+        for (unsigned int i = 0; i < loaded; i++) {
+            snprintf(line, sizeof(line), "v%lu -- v%lu\n", next_random() % n, next_random() % n);
+            append_text(text, sizeof(text), line);
+        }
+        g = read_text(text);
+        pre_calcula(g, CALCULA_CORTES);
+
+        for (unsigned int i = loaded; i < m; i++) {
+            snprintf(x, sizeof(x), "v%lu", next_random() % n);
+            snprintf(y, sizeof(y), "v%lu", next_random() % n);
+            insert_and_check(g, text, sizeof(text), x, y);
+        }
+
+        grafo* h = read_text(text);
+        char* t = describe_blocks(h);
+        s = describe_blocks(g);
+        CHECK(strcmp(s, t) == 0);
+        free(s);
+        free(t);
+        destroi_grafo(h);
+        destroi_grafo(g);
+    }
+}
+
+//------------------------------------------------------------------------------
+// devolve o número de arquivos no diretório 'dir'
+unsigned int count_files(const char* dir)
+{
+    unsigned int n = 0;
+    struct dirent* e;
+    DIR* d;
+
+    if (!(d = opendir(dir)))
+        return 0;
+    while ((e = readdir(d)))
+        if (strcmp(e->d_name, ".") && strcmp(e->d_name, ".."))
+            n++;
+    closedir(d);
+
+    return n;
+}
+
+//------------------------------------------------------------------------------
+// grava g em 'path' com salva_grafo_binario() e devolve o grafo carregado de lá
+grafo* save_and_load(grafo* g, const char* path)
+{
+    grafo* h;
+
+    CHECK(salva_grafo_binario(g, path) == 1);
+    CHECK((h = carrega_grafo_binario(path)) != NULL);
+    if (!h) {
+        fprintf(stderr, "nao foi possivel carregar %s\n", path);
+        exit(EXIT_FAILURE);
+    }
+
+    return h;
+}
+
+//------------------------------------------------------------------------------
+// um grafo gravado por salva_grafo_binario() e carregado por carrega_grafo_binario()
+// tem os mesmos resultados, antes e depois de inserções, que o grafo original e que
+// uma leitura do grafo com as mesmas arestas; um arquivo alterado é recusado
+void test_snapshot(void)
+{
+    char dir[] = "/tmp/testesXXXXXX";
+    char path[64], text[4096], line[64];
+    unsigned char* data;
+    long size;
+    FILE* f;
+    grafo *g, *h, *r;
+
+    if (!mkdtemp(dir)) {
+        fprintf(stderr, "nao foi possivel criar diretorio temporario\n");
+        exit(EXIT_FAILURE);
+    }
+    snprintf(path, sizeof(path), "%s/grafo.bin", dir);
+
+    for (unsigned int seed = 0; seed < 100; seed++) {
+        unsigned int n = 2 + (unsigned int)(next_random() % 14);
+        unsigned int m = (unsigned int)(next_random() % (2 * n + 1));
+        unsigned int loaded = (unsigned int)(next_random() % (m + 1));
+
+        snprintf(text, sizeof(text), "aleatorio%u\n", seed);
+        for (unsigned int i = 0; i < loaded; i++) {
+            snprintf(line, sizeof(line), "v%lu -- v%lu %lu\n", next_random() % n,
+                next_random() % n, 1 + next_random() % 3);
+            append_text(text, sizeof(text), line);
+        }
+        g = read_text(text);
+        pre_calcula(g, (unsigned int)(next_random() % (CALCULA_TUDO + 1)));
+
+        // o arquivo temporário da gravação é renomeado sobre o destino
+        h = save_and_load(g, path);
+        CHECK(count_files(dir) == 1);
+        check_same_results(g, h);
+        check_same_cuts(g, h);
+
+        for (unsigned int i = loaded; i < m; i++) {
+            char x[16], y[16];
+
+            snprintf(x, sizeof(x), "v%lu", next_random() % n);
+            snprintf(y, sizeof(y), "v%lu", next_random() % n);
+            adiciona_aresta(g, x, y, 1);
+            adiciona_aresta(h, x, y, 1);
+            snprintf(line, sizeof(line), "%s -- %s\n", x, y);
+            append_text(text, sizeof(text), line);
+        }
+        r = read_text(text);
+        check_same_results(h, r);
+        check_same_cuts(h, r);
+        check_same_results(g, h);
+        destroi_grafo(r);
+        destroi_grafo(g);
+
+        // o grafo alterado é gravado sobre o arquivo que ele ainda mapeia
+        g = save_and_load(h, path);
+        check_same_results(g, h);
+        check_same_cuts(g, h);
+        destroi_grafo(g);
+        destroi_grafo(h);
+    }
+
+    // qualquer byte alterado é recusado, assim como o arquivo truncado
+    g = read_text("ciclo\na -- b\nb -- c 2\nc -- a\nc -- d\n");
+    pre_calcula(g, CALCULA_TUDO);
+    CHECK(salva_grafo_binario(g, path) == 1);
+    destroi_grafo(g);
+    if (!(f = fopen(path, "rb")) || fseek(f, 0, SEEK_END) || ((size = ftell(f)) <= 0)) {
+        fprintf(stderr, "nao foi possivel ler %s\n", path);
+        exit(EXIT_FAILURE);
+    }
+    if (!(data = malloc((size_t)size))) {
+        fprintf(stderr, "nao foi possivel alocar %ld bytes\n", size);
+        exit(EXIT_FAILURE);
+    }
+    rewind(f);
+    CHECK(fread(data, 1, (size_t)size, f) == (size_t)size);
+    fclose(f);
+
+    for (long i = 0; i <= size; i++) {
+        if (i < size)
+            data[i] ^= 0x10;
+        f = fopen(path, "wb");
+        CHECK(fwrite(data, 1, (size_t)(i < size ? size : size - 8), f) > 0);
+        fclose(f);
+        g = carrega_grafo_binario(path);
+        CHECK(g == NULL);
+        if (g)
+            destroi_grafo(g);
+        if (i < size)
+            data[i] ^= 0x10;
+    }
+
+    free(data);
+    unlink(path);
+    rmdir(dir);
+}
+
+// itens recebidos de visita_*(): 'text' os acumula separados por brancos, e a
+// visita para no item de número 'stop' (0 para nunca)
+typedef struct {
+    char text[65536];
+    size_t len;
+    unsigned int n, stop;
+} collected;
+
+//------------------------------------------------------------------------------
+// acrescenta 'item' aos itens em 'dados' (um collected)
+int collect_item(const char* item, void* dados)
+{
+    collected* c = dados;
+    int len = snprintf(c->text + c->len, sizeof(c->text) - c->len, "%s%s",
+        c->n ? " " : "", item);
+
+    if ((len < 0) || ((size_t)len >= sizeof(c->text) - c->len)) {
+        fprintf(stderr, "nao foi possivel guardar os itens visitados\n");
+        exit(EXIT_FAILURE);
+    }
+    c->len += (size_t)len;
+
+    return ++c->n == c->stop;
+}
+
+//------------------------------------------------------------------------------
+// escreve_*() escreve a mesma resposta que a função que devolve a "string", e
+// visita_*() visita os mesmos itens na mesma ordem, parando quando pedido
+void check_streaming(grafo* g)
+{
+    struct {
+        char* (*text)(grafo* g);
+        unsigned int (*write)(grafo* g, FILE* f);
+        unsigned int (*visit)(grafo* g, int (*visita)(const char* item, void* dados), void* dados);
+        unsigned int n;
+    } kinds[] = {
+        { diametros, escreve_diametros, visita_diametros, diametros_valores(g, NULL) },
+        { vertices_corte, escreve_vertices_corte, visita_vertices_corte,
+            vertices_corte_indices(g, NULL) },
+        { arestas_corte, escreve_arestas_corte, visita_arestas_corte,
+            arestas_corte_indices(g, NULL) },
+    };
+    static collected c;
+
+    for (size_t k = 0; k < sizeof(kinds) / sizeof(kinds[0]); k++) {
+        char* s = kinds[k].text(g);
+        char* written = NULL;
+        size_t size = 0;
+        FILE* f = open_memstream(&written, &size);
+
+        if (!f) {
+            fprintf(stderr, "nao foi possivel abrir a saida em memoria\n");
+            exit(EXIT_FAILURE);
+        }
+        CHECK(kinds[k].write(g, f) == 1);
+        fclose(f);
+        CHECK(strcmp(written, s) == 0);
+        free(written);
+
+        // todos os itens, e depois só os dois primeiros
+        for (unsigned int stop = 0; stop <= 2; stop += 2) {
+            c.len = 0;
+            c.n = 0;
+            c.stop = stop;
+            c.text[0] = '\0';
+            if ((stop == 0) || (stop > kinds[k].n)) {
+                CHECK(kinds[k].visit(g, collect_item, &c) == kinds[k].n);
+                CHECK(strcmp(c.text, s) == 0);
+            } else {
+                CHECK(kinds[k].visit(g, collect_item, &c) == stop);
+                CHECK(c.n == stop);
+                CHECK(strncmp(c.text, s, c.len) == 0);
+                CHECK((s[c.len] == ' ') || ((stop == kinds[k].n) && (s[c.len] == '\0')));
+            }
+        }
+        free(s);
+    }
+}
+
+//------------------------------------------------------------------------------
+// as variantes que escrevem num arquivo ou visitam os itens dão as mesmas respostas
+// que as que montam a "string", nos exemplos, num grafo sem vértices e num sem
+// arestas
+void test_streaming(void)
+{
+    const char* files[] = { "exemplos/cidades.dot", "exemplos/heawood.dot",
+        "exemplos/paises.dot", "exemplos/petersen.dot", "exemplos/teste1.in",
+        "exemplos/teste2.in", "exemplos/teste3.in", "exemplos/teste4.in",
+        "exemplos/teste5.in" };
+    grafo* g;
+
+    for (size_t i = 0; i < sizeof(files) / sizeof(files[0]); i++) {
+        if (!(g = le_grafo_arquivo(files[i]))) {
+            CHECK(!"exemplo não pôde ser lido");
+            continue;
+        }
+        check_streaming(g);
+        destroi_grafo(g);
+    }
+
+    g = read_text("vazio\n");
+    check_streaming(g);
+    destroi_grafo(g);
+    g = read_text("isolados\na\nb\n");
+    check_streaming(g);
+    destroi_grafo(g);
+}
+
+//------------------------------------------------------------------------------
+// um grafo sem vértices, e um sem arestas, têm respostas vazias em todas as formas,
+// inclusive depois de gravados e carregados
+void test_empty(void)
+{
+    const char* texts[] = { "vazio\n", "isolados\na\nb\n" };
+    char dir[] = "/tmp/testesXXXXXX";
+    char path[64];
+    char* s;
+
+    if (!mkdtemp(dir)) {
+        fprintf(stderr, "nao foi possivel criar diretorio temporario\n");
+        exit(EXIT_FAILURE);
+    }
+    snprintf(path, sizeof(path), "%s/grafo.bin", dir);
+
+    for (size_t i = 0; i < sizeof(texts) / sizeof(texts[0]); i++) {
+        grafo* g = read_text(texts[i]);
+        unsigned int n = (unsigned int)i * 2;
+
+        for (unsigned int round = 0; round < 2; round++) {
+            CHECK((n_vertices(g) == n) && (n_arestas(g) == 0) && (n_componentes(g) == n));
+            CHECK(bipartido(g) == 1);
+            s = vertices_corte(g);
+            CHECK(strcmp(s, "") == 0);
+            free(s);
+            s = arestas_corte(g);
+            CHECK(strcmp(s, "") == 0);
+            free(s);
+            s = diametros(g);
+            CHECK(strcmp(s, n ? "0 0" : "") == 0);
+            free(s);
+            CHECK(vertices_corte_indices(g, NULL) == 0);
+            CHECK(arestas_corte_indices(g, NULL) == 0);
+            CHECK(diametros_valores(g, NULL) == n);
+
+            grafo* h = save_and_load(g, path);
+            destroi_grafo(g);
+            g = h;
+        }
+        destroi_grafo(g);
+    }
+
+    unlink(path);
+    rmdir(dir);
+}
+
+//------------------------------------------------------------------------------
+// renumera g na ordem 'ordem' e verifica que 'anterior' é a permutação inversa da
+// nova numeração e que os nomes e todos os resultados são os de h, o mesmo grafo
+// sem renumerar
+void check_reorder(grafo* g, grafo* h, unsigned int ordem)
+{
+    unsigned int n = n_vertices(g), n_cut;
+    unsigned int* anterior = malloc(sizeof(unsigned int) * (n + 1));
+    unsigned int* cut_g = malloc(sizeof(unsigned int) * (n + 1));
+    unsigned int* cut_h = malloc(sizeof(unsigned int) * (n + 1));
+    unsigned char* seen = calloc(n + 1, 1);
+    int permutation = 1, names = 1, cuts = 1;
+    char *s, *t;
+
+    if (!anterior || !cut_g || !cut_h || !seen) {
+        fprintf(stderr, "nao foi possivel alocar permutacao\n");
+        exit(EXIT_FAILURE);
+    }
+
+    CHECK(reordena_vertices(g, ordem, anterior) == 1);
+    CHECK(n_vertices(g) == n);
+    for (unsigned int i = 0; i < n; i++) {
+        if ((anterior[i] >= n) || seen[anterior[i]]) {
+            permutation = 0;
+            continue;
+        }
+        seen[anterior[i]] = 1;
+        if (strcmp(nome_vertice(g, i), nome_vertice(h, anterior[i]))
+            || (busca_vertice(g, nome_vertice(g, i)) != i))
+            names = 0;
+    }
+    CHECK(permutation);
+    CHECK(names);
+
+    check_same_results(g, h);
+    check_same_cuts(g, h);
+    s = describe_blocks(g);
+    t = describe_blocks(h);
+    CHECK(strcmp(s, t) == 0);
+    free(s);
+    free(t);
+    s = describe_2ecc(g);
+    t = describe_2ecc(h);
+    CHECK(strcmp(s, t) == 0);
+    free(s);
+    free(t);
+
+    // os índices dos vértices de corte de g, levados pela permutação aos de h, são
+    // os mesmos
+    n_cut = vertices_corte_indices(g, cut_g);
+    CHECK(vertices_corte_indices(h, cut_h) == n_cut);
+    if (permutation) {
+        for (unsigned int i = 0; i < n_cut; i++)
+            cut_g[i] = anterior[cut_g[i]];
+        qsort(cut_g, n_cut, sizeof(unsigned int), comp_unsigned);
+        qsort(cut_h, n_cut, sizeof(unsigned int), comp_unsigned);
+        for (unsigned int i = 0; i < n_cut; i++)
+            cuts = cuts && (cut_g[i] == cut_h[i]);
+        CHECK(cuts);
+    }
+
+    free(anterior);
+    free(cut_g);
+    free(cut_h);
+    free(seen);
+}
+
+//------------------------------------------------------------------------------
+// reordena_vertices() muda só os índices: os nomes, componentes, cortes, blocos e
+// diâmetros são os mesmos, antes e depois de inserções
+void test_reorder(void)
+{
+    const char* files[] = { "exemplos/cidades.dot", "exemplos/heawood.dot",
+        "exemplos/paises.dot", "exemplos/petersen.dot", "exemplos/teste1.in",
+        "exemplos/teste2.in", "exemplos/teste3.in", "exemplos/teste4.in",
+        "exemplos/teste5.in" };
+    char text[4096], line[64];
+    grafo *g, *h;
+
+    g = read_text("ordem\na -- b\n");
+    CHECK(reordena_vertices(g, ORDEM_GRAU + 1, NULL) == 0);
+    CHECK(reordena_vertices(g, ORDEM_RCM, NULL) == 1);
+    destroi_grafo(g);
+
+    // os resultados calculados antes da renumeração são descartados e calculados de
+    // novo
+    for (size_t i = 0; i < sizeof(files) / sizeof(files[0]); i++) {
+        for (unsigned int ordem = ORDEM_BFS; ordem <= ORDEM_GRAU; ordem++) {
+            if (!(g = le_grafo_arquivo(files[i])) || !(h = le_grafo_arquivo(files[i]))) {
+                CHECK(!"exemplo não pôde ser lido");
+                if (g)
+                    destroi_grafo(g);
+                continue;
+            }
+            if (ordem == ORDEM_RCM)
+                pre_calcula(g, CALCULA_TUDO);
+            check_reorder(g, h, ordem);
+            destroi_grafo(g);
+            destroi_grafo(h);
+        }
+    }
+
+    // grafos aleatórios, com componentes isolados e laços, renumerados e depois
+    // alterados por inserções
+    for (unsigned int seed = 0; seed < 200; seed++) {
+        unsigned int n = 2 + (unsigned int)(next_random() % 14);
+        unsigned int m = (unsigned int)(next_random() % (2 * n + 1));
+        unsigned int loaded = (unsigned int)(next_random() % (m + 1));
+
+        snprintf(text, sizeof(text), "aleatorio%u\n", seed);
+        for (unsigned int i = 0; i < loaded; i++) {
+            snprintf(line, sizeof(line), "v%lu -- v%lu %lu\n", next_random() % n,
+                next_random() % n, 1 + next_random() % 3);
+            append_text(text, sizeof(text), line);
+        }
+        if (next_random() % 2) {
+            snprintf(line, sizeof(line), "v%lu\n", next_random() % (n + 2));
+            append_text(text, sizeof(text), line);
+        }
+        g = read_text(text);
+        h = read_text(text);
+        if (next_random() % 2)
+            pre_calcula(g, (unsigned int)(next_random() % (CALCULA_TUDO + 1)));
+        check_reorder(g, h, (unsigned int)(next_random() % (ORDEM_GRAU + 1)));
+        destroi_grafo(h);
+
+        for (unsigned int i = loaded; i < m; i++) {
+            char x[16], y[16];
+
+            snprintf(x, sizeof(x), "v%lu", next_random() % n);
+            snprintf(y, sizeof(y), "v%lu", next_random() % n);
+            adiciona_aresta(g, x, y, 1);
+            snprintf(line, sizeof(line), "%s -- %s\n", x, y);
+            append_text(text, sizeof(text), line);
+        }
+        h = read_text(text);
+        check_same_results(g, h);
+        check_same_cuts(g, h);
+        destroi_grafo(h);
+        destroi_grafo(g);
+    }
+}
+
+//------------------------------------------------------------------------------
+// escreve em 'f' um grafo aleatório com 'n' vértices possíveis e 'm' arestas, com
+// sementes fixas, e o devolve lido de 'f'
+grafo* read_random(FILE* f, unsigned int n, unsigned int m)
+{
+    random_state = 88172645463325252ull;
+    rewind(f);
+    fprintf(f, "aleatorio\n");
+    for (unsigned int i = 0; i < m; i++)
+        fprintf(f, "v%lu -- v%lu\n", next_random() % n, next_random() % n);
+    fflush(f);
+    rewind(f);
+
+    return le_grafo(f);
+}
+
+//------------------------------------------------------------------------------
+// com mais de uma thread pedida, os componentes de um grafo grande vêm da
+// union-find compartilhada; com 0 (o padrão) ou 1, da busca em largura. Os
+// resultados são os mesmos
+void test_thread_components(void)
+{
+    FILE* f = tmpfile();
+
+    if (!f) {
+        fprintf(stderr, "nao foi possivel criar arquivo temporario\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // um componente gigante e muitos pequenos
+    for (unsigned int n_threads = 2; n_threads <= 4; n_threads *= 2) {
+        grafo* g = read_random(f, 200000, 150000);
+        grafo* h = read_random(f, 200000, 150000);
+
+        define_n_threads(g, n_threads);
+        CHECK(n_componentes(g) == n_componentes(h));
+        adiciona_aresta(g, "v0", "v1", 1);
+        adiciona_aresta(h, "v0", "v1", 1);
+        CHECK(n_componentes(g) == n_componentes(h));
+        CHECK(bipartido(g) == bipartido(h));
+        destroi_grafo(g);
+        destroi_grafo(h);
+    }
+
+    fclose(f);
+}
+
+//------------------------------------------------------------------------------
+// com -DGRAFO_STATS (make check compila também testes_estatisticas assim), uma
+// leitura seguida dos diâmetros conta linhas, buscas de nomes, arestas relaxadas
+// e operações nas filas; sem a flag, estatisticas_grafo() zera tudo e devolve 0
+void test_stats(void)
+{
+    grafo* g = le_grafo_arquivo("exemplos/cidades.dot");
+    grafo_stats stats;
+
+    if (!g) {
+        CHECK(!"exemplo não pôde ser lido");
+        return;
+    }
+    free(diametros(g));
+
+#ifdef GRAFO_STATS
+    CHECK(estatisticas_grafo(g, &stats) == 1);
+    CHECK(stats.linhas > 0);
+    CHECK(stats.buscas_nome > 0);
+    CHECK(stats.arestas_relaxadas > 0);
+    CHECK(stats.insercoes > 0);
+    CHECK(stats.remocoes > 0);
+    CHECK(stats.filas_alocadas > 0);
+    CHECK(stats.pico_bytes > 0);
+    CHECK((stats.leitura >= 0) && (stats.diametros >= 0));
+#else
+    CHECK(estatisticas_grafo(g, &stats) == 0);
+    CHECK((stats.linhas == 0) && (stats.buscas_nome == 0));
+    CHECK((stats.arestas_relaxadas == 0) && (stats.insercoes == 0));
+    CHECK((stats.remocoes == 0) && (stats.filas_alocadas == 0));
+    CHECK(stats.pico_bytes == 0);
+#endif
+
+    destroi_grafo(g);
+}
+
+//------------------------------------------------------------------------------
+int main(void)
+{
+    struct {
+        const char* name;
+        void (*run)(void);
+    } tests[] = {
+        { "arestas", test_edge_count },
+        { "arena", test_arena },
+        { "leitura", test_parser },
+        { "leitura_paralela", test_parallel_read },
+        { "diametros", test_diameter_modes },
+        { "diametros_aprox", test_diameter_bounds },
+        { "caminhos", test_kernels },
+        { "cortes_profundos", test_deep_cuts },
+        { "blocos", test_blocks },
+        { "insercoes", test_insertions },
+        { "cortes_insercoes", test_cut_insertions },
+        { "binario", test_snapshot },
+        { "escrita_visita", test_streaming },
+        { "vazio", test_empty },
+        { "reordenacao", test_reorder },
+        { "componentes_threads", test_thread_components },
+        { "estatisticas", test_stats },
+    };
+
+    for (size_t i = 0; i < sizeof(tests) / sizeof(tests[0]); i++) {
+        unsigned int failures = n_failures;
+
+        printf("%s\n", tests[i].name);
+        tests[i].run();
+        if (n_failures == failures)
+            printf("  ok\n");
+    }
+
+    printf("%u verificações, %u falhas\n", n_checks, n_failures);
+
+    return n_failures != 0;
+}